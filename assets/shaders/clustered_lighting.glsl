@@ -0,0 +1,87 @@
+// Clustered point lighting shared by mesh.frag (forward) and deferred_lighting.frag, included with
+// GL_GOOGLE_include_directive. Both shaders must bind the global set 0 described by LightClusters.
+
+layout(set = 0, binding = 4) uniform LightingUbo
+{
+    vec4 ambientLightColor;
+    uvec4 clusterDimensions; // w = number of lights
+    vec4 clusterParameters;  // x = depth slice scale, y = depth slice bias, zw = 1 / framebuffer extent
+}
+lighting;
+
+struct PointLight
+{
+    vec4 position; // w = range
+    vec4 color;    // w = intensity
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer PointLights
+{
+    PointLight pointLights[];
+};
+
+// Per cluster: x = offset into lightIndices, y = light count
+layout(std430, set = 0, binding = 2) readonly buffer LightClusters
+{
+    uvec2 clusters[];
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer LightIndices
+{
+    uint lightIndices[];
+};
+
+// Variant selection, see MeshShaderVariant. Dead branches and the fixed loop bound let the driver
+// strip and unroll each variant.
+layout(constant_id = 0) const bool SPECULAR = true;
+layout(constant_id = 1) const uint MAX_CLUSTER_LIGHTS = 256u; // LightClusters::MAX_LIGHTS_PER_CLUSTER
+layout(constant_id = 2) const float BLINN_TERM_FACTOR = 256.0; // higher values produce sharper specular highlights
+
+// Ambient light plus the lights of the froxel containing this fragment, viewDepth is the fragment's view space z
+void clusteredLighting(vec3 fragPosWorld, vec3 surfaceNormal, vec3 viewDirection, float viewDepth,
+                       out vec3 diffuseLight, out vec3 specularLight)
+{
+    diffuseLight = lighting.ambientLightColor.xyz * lighting.ambientLightColor.w;
+    specularLight = vec3(0.0);
+
+    // Find the froxel this fragment belongs to
+    uvec3 cluster;
+    cluster.xy = uvec2(gl_FragCoord.xy * lighting.clusterParameters.zw * vec2(lighting.clusterDimensions.xy));
+    cluster.z = uint(max(log(viewDepth) * lighting.clusterParameters.x - lighting.clusterParameters.y, 0.0));
+    cluster = min(cluster, lighting.clusterDimensions.xyz - uvec3(1));
+
+    uvec2 clusterLights = clusters[(cluster.z * lighting.clusterDimensions.y + cluster.y) * lighting.clusterDimensions.x + cluster.x];
+
+    for (uint i = 0; i < MAX_CLUSTER_LIGHTS; i++)
+    {
+        if (i >= clusterLights.y)
+            break;
+
+        PointLight light = pointLights[lightIndices[clusterLights.x + i]];
+
+        // Diffuse light
+        vec3 directionToLight = light.position.xyz - fragPosWorld;
+        float distanceSquared = dot(directionToLight, directionToLight); // dot(vec, vec) = len(vec)²
+
+        // Inverse square falloff, windowed to reach zero at the light's range
+        float window = clamp(1.0 - pow(distanceSquared / (light.position.w * light.position.w), 2.0), 0.0, 1.0);
+        float attenuation = window * window / distanceSquared;
+
+        directionToLight = normalize(directionToLight);
+
+        float cosAngIncidence = max(dot(surfaceNormal, directionToLight), 0);
+        vec3 intensity = light.color.xyz * light.color.w * attenuation;
+
+        diffuseLight += intensity * cosAngIncidence;
+
+        // Specular light
+        if (SPECULAR)
+        {
+            vec3 halfAngle = normalize(directionToLight + viewDirection);
+            float blinnTerm = dot(surfaceNormal, halfAngle);
+            blinnTerm = clamp(blinnTerm, 0.0, 1.0);
+            blinnTerm = pow(blinnTerm, BLINN_TERM_FACTOR);
+            specularLight += intensity * blinnTerm;
+        }
+    }
+}
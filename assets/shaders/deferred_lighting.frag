@@ -0,0 +1,48 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform CameraUbo
+{
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    mat4 inverseViewMatrix;
+    mat4 viewProjectionMatrix;
+}
+ubo;
+
+#include "clustered_lighting.glsl"
+
+// G-buffer written by the geometry subpass
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inAlbedo;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inNormal;
+layout(input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput inDepth;
+
+void main()
+{
+    float depth = subpassLoad(inDepth).r;
+
+    // Nothing was drawn here
+    if (depth >= 1.0)
+        discard;
+
+    vec3 albedo = subpassLoad(inAlbedo).rgb;
+    vec3 surfaceNormal = normalize(subpassLoad(inNormal).xyz);
+
+    // Reconstruct the view space position from depth, the projection stores z in [2][3] = 1
+    vec2 ndc = gl_FragCoord.xy * lighting.clusterParameters.zw * 2.0 - 1.0;
+    float viewDepth = ubo.projectionMatrix[3][2] / (depth - ubo.projectionMatrix[2][2]);
+    vec3 positionView = vec3(ndc.x * viewDepth / ubo.projectionMatrix[0][0],
+                             ndc.y * viewDepth / ubo.projectionMatrix[1][1], viewDepth);
+    vec3 fragPosWorld = (ubo.inverseViewMatrix * vec4(positionView, 1.0)).xyz;
+
+    vec3 cameraPosWorld = ubo.inverseViewMatrix[3].xyz;
+    vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
+
+    vec3 diffuseLight;
+    vec3 specularLight;
+    clusteredLighting(fragPosWorld, surfaceNormal, viewDirection, viewDepth, diffuseLight, specularLight);
+
+    outColor = vec4(diffuseLight * albedo + specularLight * albedo, 1.0);
+}
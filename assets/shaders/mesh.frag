@@ -0,0 +1,53 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragPosWorld;
+layout(location = 2) in vec3 fragNormalWorld;
+layout(location = 3) in vec2 fragUv;
+
+layout(location = 0) out vec4 outColor;
+
+layout(push_constant) uniform Push
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+}
+push;
+
+layout(set = 0, binding = 0) uniform CameraUbo
+{
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    mat4 inverseViewMatrix;
+    mat4 viewProjectionMatrix;
+}
+ubo;
+
+#include "clustered_lighting.glsl"
+
+// The textured variant is compiled separately with TEXTURED defined (see compile.sh), so the untextured SPIR-V
+// never references set 1 and can be drawn without binding it
+#ifdef TEXTURED
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+#endif
+
+void main()
+{
+    vec3 surfaceNormal = normalize(fragNormalWorld);
+
+    vec3 cameraPosWorld = ubo.inverseViewMatrix[3].xyz;
+    vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
+    float viewDepth = (ubo.viewMatrix * vec4(fragPosWorld, 1.0)).z;
+
+    vec3 diffuseLight;
+    vec3 specularLight;
+    clusteredLighting(fragPosWorld, surfaceNormal, viewDirection, viewDepth, diffuseLight, specularLight);
+
+    vec3 albedo = fragColor;
+#ifdef TEXTURED
+    albedo *= texture(texSampler, fragUv).rgb;
+#endif
+
+    outColor = vec4(diffuseLight * albedo + specularLight * albedo, 1.0);
+}
@@ -17,27 +17,19 @@ layout(location = 1) out vec3 fragPosWorld;
 layout(location = 2) out vec3 fragNormalWorld;
 layout(location = 3) out vec2 fragUv;
 
-struct PointLight
-{
-    vec3 position;
-    vec4 color; // w = intensity
-};
-
-layout(set = 0, binding = 0) uniform GlobalUbo
+layout(set = 0, binding = 0) uniform CameraUbo
 {
     mat4 projectionMatrix;
     mat4 viewMatrix;
     mat4 inverseViewMatrix;
-    vec4 ambientLightColor;
-    PointLight pointLights[10];
-    int numLights;
+    mat4 viewProjectionMatrix;
 }
 ubo;
 
 void main()
 {
    vec4 positionWorld = push.modelMatrix * vec4(inPosition, 1.0);
-   gl_Position = ubo.projectionMatrix * ubo.viewMatrix * positionWorld;
+   gl_Position = ubo.viewProjectionMatrix * positionWorld;
 
    fragColor = inColor;
    fragPosWorld = positionWorld.xyz;
@@ -0,0 +1,32 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragPosWorld;
+layout(location = 2) in vec3 fragNormalWorld;
+layout(location = 3) in vec2 fragUv;
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+
+layout(push_constant) uniform Push
+{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+}
+push;
+
+// Compiled with and without TEXTURED like mesh.frag
+#ifdef TEXTURED
+layout(set = 1, binding = 0) uniform sampler2D texSampler;
+#endif
+
+void main()
+{
+    vec3 albedo = fragColor;
+#ifdef TEXTURED
+    albedo *= texture(texSampler, fragUv).rgb;
+#endif
+
+    outAlbedo = vec4(albedo, 1.0);
+    outNormal = vec4(normalize(fragNormalWorld), 0.0);
+}
@@ -1,41 +1,30 @@
 #version 450
 
-layout(location = 0) out vec2 fragOffset;
+layout(location = 0) in vec4 inPosition; // w = radius
+layout(location = 1) in vec4 inColor;    // w = intensity
 
-struct PointLight
-{
-    vec3 position;
-    vec4 color; // w = intensity
-};
+layout(location = 0) out vec2 fragOffset;
+layout(location = 1) out vec4 fragColor;
 
-layout(set = 0, binding = 0) uniform GlobalUbo
+layout(set = 0, binding = 0) uniform CameraUbo
 {
     mat4 projectionMatrix;
     mat4 viewMatrix;
     mat4 inverseViewMatrix;
-    vec4 ambientLightColor;
-    PointLight pointLights[10];
-    int numLights;
+    mat4 viewProjectionMatrix;
 }
 ubo;
 
-layout(push_constant) uniform Push
-{
-    vec3 position;
-    vec4 color;
-    float radius;
-}
-push;
-
 const vec2 OFFSETS[6] =
     vec2[](vec2(-1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
 
 void main()
 {
     fragOffset = OFFSETS[gl_VertexIndex];
+    fragColor = inColor;
 
-    vec4 lightInCameraSpace = ubo.viewMatrix * vec4(push.position, 1.0);
-    vec4 positionInCameraSpace = lightInCameraSpace + push.radius * vec4(fragOffset, 0.0, 0.0);
+    vec4 lightInCameraSpace = ubo.viewMatrix * vec4(inPosition.xyz, 1.0);
+    vec4 positionInCameraSpace = lightInCameraSpace + inPosition.w * vec4(fragOffset, 0.0, 0.0);
 
     gl_Position = ubo.projectionMatrix * positionInCameraSpace;
 }
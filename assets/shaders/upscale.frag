@@ -0,0 +1,39 @@
+#version 450
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D sourceImage;
+
+layout(push_constant) uniform Push
+{
+    vec2 uvScale;   // rendered part of the source image
+    vec2 texelSize; // 1 / source image extent
+    float sharpness;
+}
+push;
+
+// Keeps bilinear taps from reaching texels outside the rendered part
+vec3 fetch(vec2 uv)
+{
+    vec2 lower = 0.5 * push.texelSize;
+    vec2 upper = push.uvScale - 0.5 * push.texelSize;
+    return texture(sourceImage, clamp(uv, lower, upper)).rgb;
+}
+
+void main()
+{
+    // The output has the source image's extent, so its texel size maps output pixels to source coordinates
+    vec2 uv = gl_FragCoord.xy * push.texelSize * push.uvScale;
+
+    vec3 color = fetch(uv);
+
+    if (push.sharpness > 0.0)
+    {
+        // Unsharp mask over the direct neighbours at the rendered resolution
+        vec3 blur = 0.25 * (fetch(uv + vec2(push.texelSize.x, 0.0)) + fetch(uv - vec2(push.texelSize.x, 0.0)) +
+                            fetch(uv + vec2(0.0, push.texelSize.y)) + fetch(uv - vec2(0.0, push.texelSize.y)));
+        color = max(color + (color - blur) * push.sharpness, vec3(0.0));
+    }
+
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,377 @@
+#include "Microbench.hpp"
+
+#include "SVKE/Core/Math/TransformBatch.hpp"
+#include "SVKE/Rendering/Camera.hpp"
+#include "SVKE/Rendering/Resources/Model.hpp"
+#include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Rendering/Systems/PointLightSystem.hpp"
+#include "SVKE/Utils/HashCombine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// CPU hot paths of a frame and of asset loading, at the sizes they see in practice.
+// Usage: svke-microbench [--filter name] [--json out.json] [--baseline previous.json] [--tolerance 0.1]
+
+namespace
+{
+constexpr uint32_t SEED = 1234;
+
+std::vector<vk::Object::TransformComponent> makeTransforms(const size_t count)
+{
+    std::mt19937 rng(SEED);
+    std::uniform_real_distribution<float> position(-100.f, 100.f);
+    std::uniform_real_distribution<float> angle(-vk::Angle::Rad180, vk::Angle::Rad180);
+    std::uniform_real_distribution<float> scale(.1f, 4.f);
+
+    std::vector<vk::Object::TransformComponent> transforms(count);
+    for (auto &transform : transforms)
+    {
+        transform.setTranslation({position(rng), position(rng), position(rng)});
+        transform.setRotation({angle(rng), angle(rng), angle(rng)});
+        transform.setScale({scale(rng), scale(rng), scale(rng)});
+    }
+
+    return transforms;
+}
+
+// The vertex stream of an indexed grid mesh as an OBJ loader sees it: every triangle corner is listed, so each
+// vertex shows up about six times
+std::vector<vk::Vertex> makeVertexStream(const size_t corner_count)
+{
+    const size_t side = std::max<size_t>(static_cast<size_t>(std::sqrt(static_cast<double>(corner_count) / 6.0)), 1);
+
+    std::vector<vk::Vertex> stream;
+    stream.reserve(corner_count);
+
+    const auto vertex = [&](const size_t x, const size_t y) {
+        const float u = static_cast<float>(x) / static_cast<float>(side);
+        const float v = static_cast<float>(y) / static_cast<float>(side);
+        return vk::Vertex{{u, 0.f, v}, {1.f, 1.f, 1.f}, {0.f, -1.f, 0.f}, {u, v}};
+    };
+
+    for (size_t y = 0; stream.size() < corner_count; y = (y + 1) % side)
+    {
+        for (size_t x = 0; x < side && stream.size() < corner_count; ++x)
+        {
+            stream.insert(stream.end(), {vertex(x, y), vertex(x, y + 1), vertex(x + 1, y), vertex(x, y + 1),
+                                         vertex(x + 1, y + 1), vertex(x + 1, y)});
+        }
+    }
+
+    stream.resize(corner_count);
+
+    return stream;
+}
+
+/* TRANSFORMS ----------------------------------------------------------------------------------------------- */
+
+// Every transform changed this frame, mat4() recomputes both matrices
+void transformMat4Dirty(vk::bench::State &state)
+{
+    auto transforms = makeTransforms(static_cast<size_t>(state.getArg()));
+    float angle = 0.f;
+
+    for (auto _ : state)
+    {
+        angle += .001f;
+
+        for (auto &transform : transforms)
+        {
+            transform.setRotation({angle, transform.getRotation().y, transform.getRotation().z});
+            vk::bench::doNotOptimize(transform.mat4());
+        }
+    }
+
+    state.setItemsProcessed(state.getIterations() * transforms.size());
+}
+SVKE_BENCHMARK(transformMat4Dirty).arg(1000).arg(10000).arg(100000);
+
+// Nothing changed, mat4() returns the cached matrix
+void transformMat4Cached(vk::bench::State &state)
+{
+    auto transforms = makeTransforms(static_cast<size_t>(state.getArg()));
+
+    for (auto &transform : transforms)
+        transform.mat4();
+
+    for (auto _ : state)
+    {
+        for (auto &transform : transforms)
+            vk::bench::doNotOptimize(transform.mat4());
+    }
+
+    state.setItemsProcessed(state.getIterations() * transforms.size());
+}
+SVKE_BENCHMARK(transformMat4Cached).arg(1000).arg(100000);
+
+void transformNormalMatrixDirty(vk::bench::State &state)
+{
+    auto transforms = makeTransforms(static_cast<size_t>(state.getArg()));
+    float scale = 1.f;
+
+    for (auto _ : state)
+    {
+        scale = scale > 2.f ? 1.f : scale + .001f;
+
+        for (auto &transform : transforms)
+        {
+            transform.setScale({scale, transform.getScale().y, transform.getScale().z});
+            vk::bench::doNotOptimize(transform.normalMatrix());
+        }
+    }
+
+    state.setItemsProcessed(state.getIterations() * transforms.size());
+}
+SVKE_BENCHMARK(transformNormalMatrixDirty).arg(1000).arg(10000).arg(100000);
+
+// Every transform changed this frame, TransformBatch rebuilds both matrices from structure-of-arrays input. Compare
+// with transformMat4Dirty and transformNormalMatrixDirty for the per object path. A path the CPU lacks runs the
+// scalar kernel instead and says so in the label.
+void transformBatch(vk::bench::State &state, const vk::TransformBatch::Path path)
+{
+    auto transforms = makeTransforms(static_cast<size_t>(state.getArg()));
+    const size_t count = transforms.size();
+
+    std::vector<float> soa[9]; // translation xyz, rotation xyz, scale xyz
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        soa[axis].reserve(count);
+        soa[3 + axis].reserve(count);
+        soa[6 + axis].reserve(count);
+
+        for (const auto &transform : transforms)
+        {
+            soa[axis].push_back(transform.getTranslation()[axis]);
+            soa[3 + axis].push_back(transform.getRotation()[axis]);
+            soa[6 + axis].push_back(transform.getScale()[axis]);
+        }
+    }
+
+    vk::TransformBatch::Input input;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        input.translation[axis] = soa[axis].data();
+        input.rotation[axis] = soa[3 + axis].data();
+        input.scale[axis] = soa[6 + axis].data();
+    }
+    input.count = count;
+
+    const auto run_path = vk::TransformBatch::isPathSupported(path) ? path : vk::TransformBatch::Path::Scalar;
+
+    std::vector<vk::Mat4f> world_matrices(count);
+    std::vector<vk::Mat3f> normal_matrices(count);
+
+    for (auto _ : state)
+    {
+        vk::TransformBatch::compute(input, world_matrices.data(), normal_matrices.data(), run_path);
+        vk::bench::clobberMemory();
+    }
+
+    state.setItemsProcessed(state.getIterations() * count);
+
+    // Largest difference to the per object matrices, not timed
+    float error = 0.f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const vk::Mat4f &reference = transforms[i].mat4();
+
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                error = std::max(error, std::abs(world_matrices[i][c][r] - reference[c][r]));
+    }
+
+    const std::string error_label = "max error " + std::to_string(error);
+    state.setLabel(run_path == path ? error_label
+                                    : std::string(vk::TransformBatch::getPathName(path)) + " not supported, ran " +
+                                          vk::TransformBatch::getPathName(run_path) + ", " + error_label);
+}
+
+void transformBatchScalar(vk::bench::State &state)
+{
+    transformBatch(state, vk::TransformBatch::Path::Scalar);
+}
+SVKE_BENCHMARK(transformBatchScalar).arg(1000).arg(10000).arg(100000);
+
+void transformBatchSSE(vk::bench::State &state)
+{
+    transformBatch(state, vk::TransformBatch::Path::SSE);
+}
+SVKE_BENCHMARK(transformBatchSSE).arg(1000).arg(10000).arg(100000);
+
+void transformBatchAVX2(vk::bench::State &state)
+{
+    transformBatch(state, vk::TransformBatch::Path::AVX2);
+}
+SVKE_BENCHMARK(transformBatchAVX2).arg(1000).arg(10000).arg(100000);
+
+/* CAMERA --------------------------------------------------------------------------------------------------- */
+
+// Once per frame in the app, but also per view for shadows and reflections
+void cameraSetViewYXZ(vk::bench::State &state)
+{
+    vk::Camera camera;
+    vk::Vec3f position{0.f, -1.f, -2.f};
+    vk::Vec3f rotation{.1f, .2f, 0.f};
+
+    for (auto _ : state)
+    {
+        rotation.y += .0001f;
+        position.x += .0001f;
+
+        camera.setViewYXZ(position, rotation);
+        vk::bench::doNotOptimize(camera.getViewMatrix());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+SVKE_BENCHMARK(cameraSetViewYXZ);
+
+/* VERTEX DEDUPLICATION ------------------------------------------------------------------------------------- */
+
+void vertexHash(vk::bench::State &state)
+{
+    const auto stream = makeVertexStream(static_cast<size_t>(state.getArg()));
+    const std::hash<vk::Vertex> hash;
+
+    for (auto _ : state)
+    {
+        size_t combined = 0;
+        for (const auto &vertex : stream)
+            combined ^= hash(vertex);
+
+        vk::bench::doNotOptimize(combined);
+    }
+
+    state.setItemsProcessed(state.getIterations() * stream.size());
+}
+SVKE_BENCHMARK(vertexHash).arg(10000).arg(1000000);
+
+// Model::loadFromFile turns the corner stream into unique vertices and indices with it
+void vertexDedup(vk::bench::State &state)
+{
+    const auto stream = makeVertexStream(static_cast<size_t>(state.getArg()));
+
+    vk::VertexArray vertices;
+    vk::IndexArray indices;
+
+    for (auto _ : state)
+    {
+        vk::Model::deduplicate(stream, vertices, indices);
+
+        vk::bench::doNotOptimize(indices.data());
+        vk::bench::clobberMemory();
+    }
+
+    state.setItemsProcessed(state.getIterations() * stream.size());
+    state.setLabel(std::to_string(vertices.size()) + " unique");
+}
+SVKE_BENCHMARK(vertexDedup).arg(10000).arg(100000).arg(1000000);
+
+/* POINT LIGHT SORT ----------------------------------------------------------------------------------------- */
+
+std::vector<vk::Vec3f> makeLightPositions(const size_t count)
+{
+    std::mt19937 rng(SEED);
+    std::uniform_real_distribution<float> position(-50.f, 50.f);
+
+    std::vector<vk::Vec3f> positions(count);
+    for (auto &p : positions)
+        p = {position(rng), position(rng), position(rng)};
+
+    return positions;
+}
+
+// PointLightSystem::render sorts the light billboards with it every frame
+void pointLightSortRadix(vk::bench::State &state)
+{
+    const auto positions = makeLightPositions(static_cast<size_t>(state.getArg()));
+    std::vector<vk::PointLightSystem::SortEntry> entries;
+    std::vector<vk::PointLightSystem::SortEntry> scratch;
+    vk::Vec3f camera{0.f, 0.f, -60.f};
+
+    for (auto _ : state)
+    {
+        camera.x += .01f;
+
+        vk::PointLightSystem::sortBackToFront(camera, positions, entries, scratch);
+        vk::bench::doNotOptimize(entries.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * positions.size());
+}
+SVKE_BENCHMARK(pointLightSortRadix).arg(64).arg(1024).arg(16384);
+
+// Reference for the radix sort above, same keys
+void pointLightSortStd(vk::bench::State &state)
+{
+    using SortEntry = vk::PointLightSystem::SortEntry;
+
+    const auto positions = makeLightPositions(static_cast<size_t>(state.getArg()));
+    std::vector<SortEntry> entries;
+    vk::Vec3f camera{0.f, 0.f, -60.f};
+
+    for (auto _ : state)
+    {
+        camera.x += .01f;
+
+        vk::PointLightSystem::computeSortEntries(camera, positions, entries);
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const SortEntry &a, const SortEntry &b) { return a.key < b.key; });
+        vk::bench::doNotOptimize(entries.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * positions.size());
+}
+SVKE_BENCHMARK(pointLightSortStd).arg(64).arg(1024).arg(16384);
+
+/* HASH COMBINE --------------------------------------------------------------------------------------------- */
+
+// The pipeline and vertex keys combine a handful of fields
+void hashCombineFields(vk::bench::State &state)
+{
+    uint64_t a = 1;
+    float b = 2.f;
+    uint32_t c = 3;
+    int d = 4;
+
+    for (auto _ : state)
+    {
+        size_t seed = 0;
+        vk::hashCombine(seed, a, b, c, d);
+        vk::bench::doNotOptimize(seed);
+
+        ++a;
+        b += 1.f;
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+SVKE_BENCHMARK(hashCombineFields);
+
+void hashCombineVec3(vk::bench::State &state)
+{
+    vk::Vec3f position{1.f, 2.f, 3.f};
+    const vk::Vec3f normal{0.f, 1.f, 0.f};
+
+    for (auto _ : state)
+    {
+        size_t seed = 0;
+        vk::hashCombine(seed, position, normal);
+        vk::bench::doNotOptimize(seed);
+
+        position.x += 1.f;
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+SVKE_BENCHMARK(hashCombineVec3);
+} // namespace
+
+int main(int argc, char **argv)
+{
+    return vk::bench::runAll(argc, argv);
+}
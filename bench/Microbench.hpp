@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness in the spirit of Google Benchmark, kept in the tree so the benchmarks build
+// without fetching anything. A benchmark is a function taking a State and looping over it:
+//
+//     void benchSomething(vk::bench::State &state)
+//     {
+//         auto data = makeData(state.getArg());     // setup, not timed
+//         for (auto _ : state)
+//             vk::bench::doNotOptimize(something(data));
+//         state.setItemsProcessed(state.getIterations() * data.size());
+//     }
+//     SVKE_BENCHMARK(benchSomething).arg(1000).arg(100000);
+//
+// Each (benchmark, argument) pair is first calibrated until one run takes at least the minimum time, then run
+// a few more times with that iteration count; the median time per iteration is reported. Results can be
+// written as JSON and compared against a previous JSON, failing the run on a regression.
+//
+// Options: --filter <substring> --min-time <seconds> --repetitions <n> --json <path>
+//          --baseline <path> --tolerance <fraction>
+
+namespace vk::bench
+{
+// Keeps the compiler from optimizing away a value that is otherwise unused
+template <typename T> inline void doNotOptimize(T &&value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+// Forces pending writes to memory to be considered visible
+inline void clobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+class State
+{
+  public:
+    class Iterator
+    {
+      public:
+        Iterator(State *state, const uint64_t remaining) : state(state), remaining(remaining) {}
+
+        // Stops the clock as soon as the loop is done, so teardown after it is not timed either
+        const bool operator!=(const Iterator &)
+        {
+            if (remaining != 0)
+                return true;
+
+            state->stop = std::chrono::steady_clock::now();
+            return false;
+        }
+
+        void operator++() { --remaining; }
+
+        // The loop variable is unused, but must be something
+        const int operator*() const { return 0; }
+
+      private:
+        State *state;
+        uint64_t remaining;
+    };
+
+    State(const int64_t arg, const uint64_t iterations) : arg(arg), iterations(iterations), itemsProcessed(0) {}
+
+    // The clock starts when the loop begins and stops when it ends, setup before it is not timed
+    Iterator begin()
+    {
+        start = std::chrono::steady_clock::now();
+        return Iterator(this, iterations);
+    }
+
+    Iterator end()
+    {
+        return Iterator(this, 0);
+    }
+
+    const int64_t getArg() const { return arg; }
+
+    const uint64_t getIterations() const { return iterations; }
+
+    void setItemsProcessed(const uint64_t items) { itemsProcessed = items; }
+
+    const uint64_t getItemsProcessed() const { return itemsProcessed; }
+
+    void setLabel(const std::string &label) { this->label = label; }
+
+    const std::string &getLabel() const { return label; }
+
+    // Time of the loop, read once the benchmark function returned
+    const double getElapsedSeconds() const { return std::chrono::duration<double>(stop - start).count(); }
+
+  private:
+    int64_t arg;
+    uint64_t iterations;
+    uint64_t itemsProcessed;
+    std::string label;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point stop;
+};
+
+using Function = std::function<void(State &)>;
+
+class Benchmark
+{
+  public:
+    Benchmark(const std::string &name, Function function) : name(name), function(std::move(function)) {}
+
+    Benchmark &arg(const int64_t value)
+    {
+        args.push_back(value);
+        return *this;
+    }
+
+    const std::string &getName() const { return name; }
+
+    const std::vector<int64_t> &getArgs() const { return args; }
+
+    const Function &getFunction() const { return function; }
+
+  private:
+    std::string name;
+    Function function;
+    std::vector<int64_t> args;
+};
+
+struct Result
+{
+    std::string name;
+    double nsPerIteration = 0.0;
+    double itemsPerSecond = 0.0;
+    uint64_t iterations = 0;
+    std::string label;
+};
+
+inline std::vector<std::unique_ptr<Benchmark>> &getRegistry()
+{
+    static std::vector<std::unique_ptr<Benchmark>> registry;
+    return registry;
+}
+
+inline Benchmark &registerBenchmark(const std::string &name, Function function)
+{
+    getRegistry().push_back(std::make_unique<Benchmark>(name, std::move(function)));
+    return *getRegistry().back();
+}
+
+// Reads the files written by writeJson(), one result per line
+inline std::map<std::string, double> readBaseline(const std::string &path)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        const size_t name_start = line.find("\"name\":\"");
+        const size_t ns_start = line.find("\"ns\":");
+        if (name_start == std::string::npos || ns_start == std::string::npos)
+            continue;
+
+        const size_t name_end = line.find('"', name_start + 8);
+        baseline[line.substr(name_start + 8, name_end - name_start - 8)] = std::atof(line.c_str() + ns_start + 5);
+    }
+
+    return baseline;
+}
+
+inline const bool writeJson(const std::string &path, const std::vector<Result> &results)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+
+    if (!file.is_open())
+        return false;
+
+    file << std::fixed << std::setprecision(3) << "{\"benchmarks\":[";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        file << (i > 0 ? "," : "") << "\n{\"name\":\"" << results[i].name << "\",\"ns\":" << results[i].nsPerIteration
+             << ",\"itemsPerSecond\":" << results[i].itemsPerSecond << ",\"iterations\":" << results[i].iterations
+             << "}";
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+inline const Result runOne(const Benchmark &benchmark, const int64_t arg, const bool has_arg, const double min_time,
+                           const int repetitions)
+{
+    Result result;
+    result.name = has_arg ? benchmark.getName() + "/" + std::to_string(arg) : benchmark.getName();
+
+    const auto run = [&](State &state) {
+        benchmark.getFunction()(state);
+        return state.getElapsedSeconds();
+    };
+
+    // Grows the iteration count until one run is long enough to time reliably
+    uint64_t iterations = 1;
+    for (;;)
+    {
+        State state(arg, iterations);
+        const double seconds = run(state);
+
+        if (seconds >= min_time || iterations >= (uint64_t(1) << 40))
+            break;
+
+        const double scale = seconds > 0.0 ? 1.4 * min_time / seconds : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) *
+                                                                    std::min(scale, 10.0)));
+    }
+
+    std::vector<double> ns_per_iteration;
+    double items_per_second = 0.0;
+
+    for (int i = 0; i < repetitions; ++i)
+    {
+        State state(arg, iterations);
+        const double seconds = run(state);
+
+        ns_per_iteration.push_back(seconds * 1e9 / static_cast<double>(iterations));
+        items_per_second = static_cast<double>(state.getItemsProcessed()) / seconds;
+        result.label = state.getLabel();
+    }
+
+    std::nth_element(ns_per_iteration.begin(), ns_per_iteration.begin() + ns_per_iteration.size() / 2,
+                     ns_per_iteration.end());
+
+    result.nsPerIteration = ns_per_iteration[ns_per_iteration.size() / 2];
+    result.itemsPerSecond = items_per_second;
+    result.iterations = iterations;
+
+    return result;
+}
+
+// Runs every registered benchmark matching the filter. Returns the process exit code: 1 on bad options or if
+// a benchmark got slower than the baseline by more than the tolerance, 0 otherwise.
+inline int runAll(const int argc, char **argv)
+{
+    std::string filter;
+    std::string json_path;
+    std::string baseline_path;
+    double min_time = .2;
+    double tolerance = .1;
+    int repetitions = 5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+
+        if (i + 1 == argc)
+        {
+            std::cerr << "MISSING VALUE FOR " << option << std::endl;
+            return 1;
+        }
+
+        const std::string value = argv[++i];
+
+        if (option == "--filter")
+            filter = value;
+        else if (option == "--json")
+            json_path = value;
+        else if (option == "--baseline")
+            baseline_path = value;
+        else if (option == "--min-time")
+            min_time = std::atof(value.c_str());
+        else if (option == "--tolerance")
+            tolerance = std::atof(value.c_str());
+        else if (option == "--repetitions")
+            repetitions = std::max(std::atoi(value.c_str()), 1);
+        else
+        {
+            std::cerr << "UNKNOWN OPTION " << option << std::endl;
+            return 1;
+        }
+    }
+
+    const std::map<std::string, double> baseline =
+        baseline_path.empty() ? std::map<std::string, double>{} : readBaseline(baseline_path);
+
+    std::vector<Result> results;
+    int regressions = 0;
+
+    std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Time (ns)"
+              << std::setw(16) << "Iterations" << std::setw(18) << "Items/s" << std::endl;
+
+    for (const auto &benchmark : getRegistry())
+    {
+        const bool has_args = !benchmark->getArgs().empty();
+        const std::vector<int64_t> args = has_args ? benchmark->getArgs() : std::vector<int64_t>{0};
+
+        for (const int64_t arg : args)
+        {
+            const std::string name = has_args ? benchmark->getName() + "/" + std::to_string(arg)
+                                              : benchmark->getName();
+
+            if (!filter.empty() && name.find(filter) == std::string::npos)
+                continue;
+
+            const Result result = runOne(*benchmark, arg, has_args, min_time, repetitions);
+
+            std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(16) << result.nsPerIteration << std::setw(16) << result.iterations
+                      << std::setprecision(0) << std::setw(18) << result.itemsPerSecond;
+
+            auto it = baseline.find(result.name);
+            if (it != baseline.end() && it->second > 0.0)
+            {
+                const double change = result.nsPerIteration / it->second - 1.0;
+                std::cout << std::showpos << std::setprecision(1) << "  " << change * 100.0 << "%" << std::noshowpos;
+
+                if (change > tolerance)
+                {
+                    std::cout << " REGRESSION";
+                    ++regressions;
+                }
+            }
+
+            if (!result.label.empty())
+                std::cout << "  " << result.label;
+
+            std::cout << std::endl;
+            results.push_back(result);
+        }
+    }
+
+    if (!json_path.empty() && !writeJson(json_path, results))
+    {
+        std::cerr << "FAILED TO WRITE " << json_path << std::endl;
+        return 1;
+    }
+
+    if (regressions > 0)
+    {
+        std::cerr << regressions << " BENCHMARK(S) REGRESSED BY MORE THAN " << tolerance * 100.0 << "%" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+} // namespace vk::bench
+
+#define SVKE_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define SVKE_BENCHMARK_CONCAT(a, b)      SVKE_BENCHMARK_CONCAT_IMPL(a, b)
+
+// Registers function under its own name, arguments can be chained: SVKE_BENCHMARK(f).arg(10).arg(1000);
+#define SVKE_BENCHMARK(function)                                                                                 \
+    static ::vk::bench::Benchmark &SVKE_BENCHMARK_CONCAT(svke_benchmark_, __LINE__) =                            \
+        ::vk::bench::registerBenchmark(#function, function)
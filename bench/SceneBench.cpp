@@ -0,0 +1,667 @@
+#include "SVKE/Core.hpp"
+#include "SVKE/Rendering.hpp"
+#include "SVKE/Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Renders a procedurally generated stress scene for a fixed number of frames while a scripted camera orbits it,
+// then writes frame time statistics, draw counts and memory usage as JSON. Everything the scene and the camera
+// do depends only on the seed and the frame number, so two builds render exactly the same frames.
+// Run from the build directory, next to the compiled assets.
+// Usage: svke-bench [--objects N] [--meshes M] [--textures K] [--lights L] [--frames F] [--warmup W]
+//                   [--width X] [--height Y] [--seed S] [--windowed] [--output path]
+
+namespace
+{
+struct Options
+{
+    uint32_t objects = 2000;
+    uint32_t meshes = 16;
+    uint32_t textures = 8;
+    uint32_t lights = 64;
+    uint32_t frames = 1000;
+    uint32_t warmup = 100;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t seed = 1234;
+    bool windowed = false;
+    std::string output = "bench_report.json";
+};
+
+// Animation advances by a fixed step instead of the measured frame time
+constexpr float FIXED_DT = 1.f / 60.f;
+
+// Objects are spread over a cube, about this far apart
+constexpr float OBJECT_SPACING = 3.f;
+
+constexpr int TEXTURE_SIZE = 256;
+
+void printUsage()
+{
+    std::cout << "Usage: svke-bench [--objects N] [--meshes M] [--textures K] [--lights L] [--frames F]"
+              << " [--warmup W] [--width X] [--height Y] [--seed S] [--windowed] [--output path]" << std::endl;
+}
+
+const Options parseOptions(const int argc, char **argv)
+{
+    Options options;
+
+    const std::map<std::string, uint32_t *> counts = {
+        {"--objects", &options.objects}, {"--meshes", &options.meshes}, {"--textures", &options.textures},
+        {"--lights", &options.lights},   {"--frames", &options.frames}, {"--warmup", &options.warmup},
+        {"--width", &options.width},     {"--height", &options.height}, {"--seed", &options.seed}};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (arg == "--windowed")
+        {
+            options.windowed = true;
+            continue;
+        }
+
+        if (i + 1 == argc)
+            throw std::invalid_argument("MISSING VALUE FOR " + arg);
+
+        if (arg == "--output")
+        {
+            options.output = argv[++i];
+            continue;
+        }
+
+        auto it = counts.find(arg);
+        if (it == counts.end())
+            throw std::invalid_argument("UNKNOWN OPTION " + arg);
+
+        *it->second = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    }
+
+    if (options.meshes == 0 || options.frames == 0 || options.width == 0 || options.height == 0)
+        throw std::invalid_argument("MESHES, FRAMES, WIDTH AND HEIGHT MUST BE POSITIVE");
+
+    return options;
+}
+
+/* SCENE GENERATION ----------------------------------------------------------------------------------------- */
+
+// A lumpy sphere: the tessellation grows with the mesh index and the surface is displaced by a few random
+// waves, so every mesh has its own vertex count and shape
+std::shared_ptr<vk::Model> generateMesh(vk::Device &device, const uint32_t index, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> frequency(1.f, 6.f);
+    std::uniform_real_distribution<float> amplitude(0.f, .15f);
+    std::uniform_real_distribution<float> tint(.3f, 1.f);
+
+    const vk::Vec3f wave_frequency = {frequency(rng), frequency(rng), frequency(rng)};
+    const float wave_amplitude = amplitude(rng);
+    const vk::Vec3f color = {tint(rng), tint(rng), tint(rng)};
+
+    const uint32_t rings = 8 + (index % 16) * 4;
+    const uint32_t segments = 2 * rings;
+
+    vk::VertexArray vertices;
+    vk::IndexArray indices;
+    vertices.reserve((rings + 1) * (segments + 1));
+    indices.reserve(rings * segments * 6);
+
+    for (uint32_t ring = 0; ring <= rings; ++ring)
+    {
+        const float v = static_cast<float>(ring) / static_cast<float>(rings);
+        const float theta = v * vk::Angle::Rad180;
+
+        for (uint32_t segment = 0; segment <= segments; ++segment)
+        {
+            const float u = static_cast<float>(segment) / static_cast<float>(segments);
+            const float phi = u * vk::Angle::Rad360;
+
+            const vk::Vec3f normal = {std::sin(theta) * std::cos(phi), std::cos(theta),
+                                      std::sin(theta) * std::sin(phi)};
+            const float radius = .5f + wave_amplitude * std::sin(wave_frequency.x * normal.x) *
+                                           std::sin(wave_frequency.y * normal.y) *
+                                           std::sin(wave_frequency.z * normal.z);
+
+            vertices.push_back(vk::Vertex{normal * radius, color, normal, {u, v}});
+        }
+    }
+
+    for (uint32_t ring = 0; ring < rings; ++ring)
+    {
+        for (uint32_t segment = 0; segment < segments; ++segment)
+        {
+            const uint32_t first = ring * (segments + 1) + segment;
+            const uint32_t second = first + segments + 1;
+
+            indices.insert(indices.end(), {first, second, first + 1, second, second + 1, first + 1});
+        }
+    }
+
+    auto model = std::make_shared<vk::Model>(device);
+    model->loadFromData(vertices, indices);
+
+    return model;
+}
+
+// Checkerboard in two random colors, the cell size differs per texture
+std::shared_ptr<vk::TextureImage> generateTexture(vk::Device &device, const uint32_t index, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> channel(0, 255);
+
+    const int cell = 4 << (index % 5);
+    const unsigned char colors[2][4] = {
+        {static_cast<unsigned char>(channel(rng)), static_cast<unsigned char>(channel(rng)),
+         static_cast<unsigned char>(channel(rng)), 255},
+        {static_cast<unsigned char>(channel(rng)), static_cast<unsigned char>(channel(rng)),
+         static_cast<unsigned char>(channel(rng)), 255}};
+
+    std::vector<unsigned char> pixels(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+
+    for (int y = 0; y < TEXTURE_SIZE; ++y)
+    {
+        for (int x = 0; x < TEXTURE_SIZE; ++x)
+        {
+            const unsigned char *color = colors[((x / cell) + (y / cell)) % 2];
+            std::copy(color, color + 4, &pixels[(y * TEXTURE_SIZE + x) * 4]);
+        }
+    }
+
+    vk::Texture texture;
+    if (!texture.loadFromData(TEXTURE_SIZE, TEXTURE_SIZE, pixels.data()))
+        throw std::runtime_error("generateTexture: FAILED TO CREATE TEXTURE");
+
+    return std::make_shared<vk::TextureImage>(device, texture);
+}
+
+// Half extent of the cube the objects are spread over
+const float getSceneExtent(const Options &options)
+{
+    return .5f * OBJECT_SPACING * std::max(std::cbrt(static_cast<float>(options.objects)), 1.f);
+}
+
+// With textures every other object is textured, so both mesh systems carry load
+void generateScene(vk::Device &device, vk::Scene &scene, const Options &options)
+{
+    std::mt19937 rng(options.seed);
+
+    std::vector<std::shared_ptr<vk::Model>> meshes;
+    for (uint32_t i = 0; i < options.meshes; ++i)
+        meshes.push_back(generateMesh(device, i, rng));
+
+    std::vector<std::shared_ptr<vk::TextureImage>> textures;
+    for (uint32_t i = 0; i < options.textures; ++i)
+        textures.push_back(generateTexture(device, i, rng));
+
+    const float extent = getSceneExtent(options);
+
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> angle(0.f, vk::Angle::Rad360);
+    std::uniform_real_distribution<float> scale(.5f, 1.5f);
+    std::uniform_int_distribution<int> channel(64, 255);
+
+    for (uint32_t i = 0; i < options.objects; ++i)
+    {
+        vk::Object object;
+        object.setModel(meshes[i % meshes.size()]);
+
+        if (!textures.empty() && i % 2 == 0)
+            object.setTextureImage(textures[(i / 2) % textures.size()]);
+
+        object.setTranslation({position(rng), position(rng), position(rng)});
+        object.setRotation({angle(rng), angle(rng), angle(rng)});
+        object.setScale(vk::Vec3f(scale(rng)));
+        scene.add(object);
+    }
+
+    for (uint32_t i = 0; i < options.lights; ++i)
+    {
+        vk::Object point_light = vk::Object::makePointLight(2.f);
+
+        point_light.setColor(vk::Color(static_cast<uint8_t>(channel(rng)), static_cast<uint8_t>(channel(rng)),
+                                       static_cast<uint8_t>(channel(rng))));
+        point_light.setTranslation({position(rng), position(rng), position(rng)});
+        scene.add(point_light);
+    }
+}
+
+// Orbits the scene once over the run while bobbing up and down, always looking at its center
+void updateCamera(vk::Camera &camera, const Options &options, const uint32_t frame, const uint32_t frame_count)
+{
+    const float extent = getSceneExtent(options);
+    const float t = static_cast<float>(frame) / static_cast<float>(frame_count);
+
+    const float orbit = 1.5f * extent + 5.f;
+    const float angle = t * vk::Angle::Rad360;
+    const vk::Vec3f position = {orbit * std::cos(angle), .5f * extent * std::sin(2.f * angle),
+                                orbit * std::sin(angle)};
+
+    camera.setViewTarget(position, {0.f, 0.f, 0.f});
+}
+
+/* REPORT --------------------------------------------------------------------------------------------------- */
+
+// The device name comes from the driver, a quote or backslash in it must not break the JSON
+void writeEscaped(std::ostream &stream, const std::string &text)
+{
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            stream << ' ';
+        else
+            stream << c;
+    }
+}
+
+void writeSummary(std::ostream &stream, const vk::RollingStatistics::Summary &summary)
+{
+    stream << "{\"count\":" << summary.count << ",\"mean\":" << summary.average << ",\"p50\":" << summary.p50
+           << ",\"p95\":" << summary.p95 << ",\"p99\":" << summary.p99 << ",\"min\":" << summary.min
+           << ",\"max\":" << summary.max << "}";
+}
+
+struct Report
+{
+    std::string deviceName;
+    vk::RollingStatistics::Summary cpuFrameTime;
+    vk::RollingStatistics::Summary gpuFrameTime;
+    std::vector<std::pair<std::string, vk::RollingStatistics::Summary>> gpuScopes;
+    // Of the last collected frame, empty when the device does not support pipeline statistics queries
+    std::vector<std::pair<std::string, vk::GpuProfiler::PipelineStatistics>> pipelineStatistics;
+    size_t meshDraws = 0;
+    size_t texturedMeshDraws = 0;
+    size_t pointLights = 0;
+
+    // Counters of the last measured frame
+    vk::FrameStats frameStats;
+};
+
+void writeMemory(std::ostream &stream, vk::Device &device)
+{
+    const vk::MemoryStats stats = device.getMemoryStats();
+
+    stream << "{\"allocationCount\":" << stats.totalAllocationCount
+           << ",\"allocationBytes\":" << stats.totalAllocationBytes << ",\"blockBytes\":" << stats.totalBlockBytes
+           << ",\"heaps\":[";
+
+    for (size_t i = 0; i < stats.heaps.size(); ++i)
+    {
+        const auto &heap = stats.heaps[i];
+
+        stream << (i > 0 ? "," : "") << "{\"deviceLocal\":" << (heap.deviceLocal ? "true" : "false")
+               << ",\"size\":" << heap.size << ",\"usage\":" << heap.usage << ",\"budget\":" << heap.budget
+               << ",\"blockBytes\":" << heap.blockBytes << ",\"allocationBytes\":" << heap.allocationBytes << "}";
+    }
+
+    stream << "],\"pools\":[";
+
+    for (size_t i = 0; i < stats.pools.size(); ++i)
+    {
+        const auto &pool = stats.pools[i];
+
+        stream << (i > 0 ? "," : "") << "{\"memoryType\":" << pool.memoryTypeIndex << ",\"heap\":" << pool.heapIndex
+               << ",\"blockCount\":" << pool.blockCount << ",\"allocationCount\":" << pool.allocationCount
+               << ",\"blockBytes\":" << pool.blockBytes << ",\"allocationBytes\":" << pool.allocationBytes
+               << ",\"fragmentation\":" << pool.fragmentation << "}";
+    }
+
+    stream << "],\"categories\":{";
+
+    for (size_t i = 0; i < vk::MemoryStats::CATEGORY_COUNT; ++i)
+    {
+        stream << (i > 0 ? "," : "") << "\""
+               << vk::MemoryStats::getCategoryName(static_cast<vk::MemoryCategory>(i))
+               << "\":{\"allocationCount\":" << stats.categories[i].allocationCount
+               << ",\"bytes\":" << stats.categories[i].bytes << "}";
+    }
+
+    stream << "}}";
+}
+
+const bool writeReport(const Options &options, const Report &report, vk::Device &device)
+{
+    std::ofstream file(options.output, std::ios::out | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cerr << "svke-bench: FAILED TO OPEN " << options.output << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(4);
+
+    file << "{\n\"config\":{\"objects\":" << options.objects << ",\"meshes\":" << options.meshes
+         << ",\"textures\":" << options.textures << ",\"lights\":" << options.lights << ",\"frames\":" << options.frames
+         << ",\"warmup\":" << options.warmup << ",\"width\":" << options.width << ",\"height\":" << options.height
+         << ",\"seed\":" << options.seed << ",\"headless\":" << (options.windowed ? "false" : "true") << "},\n";
+
+    file << "\"device\":\"";
+    writeEscaped(file, report.deviceName);
+    file << "\",\n";
+
+    file << "\"cpuFrameTimeMs\":";
+    writeSummary(file, report.cpuFrameTime);
+    file << ",\n\"gpuFrameTimeMs\":";
+    writeSummary(file, report.gpuFrameTime);
+
+    file << ",\n\"gpuScopesMs\":{";
+    for (size_t i = 0; i < report.gpuScopes.size(); ++i)
+    {
+        file << (i > 0 ? "," : "") << "\n  \"" << report.gpuScopes[i].first << "\":";
+        writeSummary(file, report.gpuScopes[i].second);
+    }
+    file << "},\n";
+
+    file << "\"gpuPipelineStatistics\":{";
+    for (size_t i = 0; i < report.pipelineStatistics.size(); ++i)
+    {
+        const auto &counters = report.pipelineStatistics[i].second;
+
+        file << (i > 0 ? "," : "") << "\n  \"" << report.pipelineStatistics[i].first
+             << "\":{\"inputAssemblyVertices\":" << counters.inputAssemblyVertices
+             << ",\"inputAssemblyPrimitives\":" << counters.inputAssemblyPrimitives
+             << ",\"vertexShaderInvocations\":" << counters.vertexShaderInvocations
+             << ",\"clippingInvocations\":" << counters.clippingInvocations
+             << ",\"clippingPrimitives\":" << counters.clippingPrimitives
+             << ",\"fragmentShaderInvocations\":" << counters.fragmentShaderInvocations << "}";
+    }
+    file << "},\n";
+
+    const vk::FrameStats &stats = report.frameStats;
+
+    file << "\"draws\":{\"meshes\":" << report.meshDraws << ",\"texturedMeshes\":" << report.texturedMeshDraws
+         << ",\"pointLights\":" << report.pointLights << ",\"drawCallsPerFrame\":" << stats.drawCalls << "},\n";
+
+    file << "\"frameStats\":{\"drawCalls\":" << stats.drawCalls << ",\"instances\":" << stats.instances
+         << ",\"triangles\":" << stats.triangles << ",\"pipelineBinds\":" << stats.pipelineBinds
+         << ",\"descriptorSetBinds\":" << stats.descriptorSetBinds
+         << ",\"pushConstantUpdates\":" << stats.pushConstantUpdates << ",\"bytesUploaded\":" << stats.bytesUploaded
+         << ",\"culledObjects\":" << stats.culledObjects << "},\n";
+
+    file << "\"memory\":";
+    writeMemory(file, device);
+    file << "\n}\n";
+
+    return file.good();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    try
+    {
+        options = parseOptions(argc, argv);
+    }
+    catch (std::invalid_argument &e)
+    {
+        std::cerr << "svke-bench: " << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    try
+    {
+        vk::Window window(static_cast<int>(options.width), static_cast<int>(options.height), "SVKE Benchmark",
+                          !options.windowed);
+        vk::Device device(window, vk::Device::MSAA::x1, "");
+
+        // Nothing may vary between runs: no frame rate limit, no latency waits, no dynamic resolution
+        vk::Renderer renderer(device, window, vk::Swapchain::PresentMode::Immediate, COLOR_BLACK,
+                              vk::Swapchain::RenderPath::Forward, vk::Swapchain::RenderingMode::Dynamic);
+        vk::PipelineManager pipeline_manager(device);
+        renderer.setPipelineManager(&pipeline_manager);
+
+        vk::Scene scene;
+        generateScene(device, scene, options);
+
+        /* DESCRIPTORS -------------------------------------------------------------------------------------- */
+
+        const uint32_t frames_in_flight = renderer.getFramesInFlight();
+
+        auto global_pool = vk::DescriptorPool::Builder(device)
+                               .setMaxSets(frames_in_flight)
+                               .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * frames_in_flight)
+                               .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * frames_in_flight)
+                               .build();
+
+        const uint32_t textured_count = std::max(static_cast<uint32_t>(scene.getTexturedMeshes().size()), 1u);
+        auto object_texture_pool = vk::DescriptorPool::Builder(device)
+                                       .setMaxSets(textured_count)
+                                       .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textured_count)
+                                       .build();
+
+        vk::TextureSampler::Config sampler_config{};
+        vk::TextureSampler::defaultTextureSamplerConfig(sampler_config);
+        vk::TextureSampler texture_sampler(device, sampler_config);
+
+        std::vector<std::unique_ptr<vk::Buffer>> camera_ubo_buffers(frames_in_flight);
+        for (auto &buffer : camera_ubo_buffers)
+        {
+            buffer = std::make_unique<vk::Buffer>(
+                device, sizeof(vk::CameraUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_MEMORY_USAGE_AUTO,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                    VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+            buffer->map();
+        }
+
+        vk::LightClusters light_clusters(device, frames_in_flight);
+
+        auto global_set_layout = vk::DescriptorSetLayout::Builder(device)
+                                     .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+                                     .addBinding(vk::LightClusters::LIGHTS_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                 VK_SHADER_STAGE_FRAGMENT_BIT)
+                                     .addBinding(vk::LightClusters::CLUSTERS_BINDING,
+                                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                                     .addBinding(vk::LightClusters::LIGHT_INDICES_BINDING,
+                                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                                     .addBinding(vk::LightClusters::LIGHTING_BINDING,
+                                                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                                     .build();
+
+        auto object_set_layout =
+            vk::DescriptorSetLayout::Builder(device)
+                .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                .build();
+
+        std::vector<VkDescriptorSetLayout> set_layouts = {global_set_layout->getDescriptorSetLayout(),
+                                                          object_set_layout->getDescriptorSetLayout()};
+
+        std::vector<VkDescriptorSet> global_descriptor_sets(frames_in_flight, VK_NULL_HANDLE);
+
+        auto write_global_descriptor_set = [&](const int frame_index) {
+            auto camera_info = camera_ubo_buffers[frame_index]->getDescriptorInfo();
+            auto lights_info = light_clusters.getLightsDescriptorInfo(frame_index);
+            auto clusters_info = light_clusters.getClustersDescriptorInfo(frame_index);
+            auto light_indices_info = light_clusters.getLightIndicesDescriptorInfo(frame_index);
+            auto lighting_info = light_clusters.getLightingDescriptorInfo(frame_index);
+
+            vk::DescriptorWriter writer(*global_set_layout, *global_pool);
+            writer.writeBuffer(0, camera_info)
+                .writeBuffer(vk::LightClusters::LIGHTS_BINDING, lights_info)
+                .writeBuffer(vk::LightClusters::CLUSTERS_BINDING, clusters_info)
+                .writeBuffer(vk::LightClusters::LIGHT_INDICES_BINDING, light_indices_info)
+                .writeBuffer(vk::LightClusters::LIGHTING_BINDING, lighting_info);
+
+            if (global_descriptor_sets[frame_index] == VK_NULL_HANDLE)
+                writer.build(global_descriptor_sets[frame_index]);
+            else
+                writer.overwrite(global_descriptor_sets[frame_index]);
+        };
+
+        for (int i = 0; i < global_descriptor_sets.size(); ++i)
+            write_global_descriptor_set(i);
+
+        for (auto &textured_mesh : scene.getTexturedMeshes())
+        {
+            auto image_info = textured_mesh.textureImage->getDescriptorInfo(texture_sampler);
+            vk::DescriptorWriter(*object_set_layout, *object_texture_pool)
+                .writeImage(0, image_info)
+                .build(textured_mesh.descriptorSet);
+        }
+
+        /* SYSTEMS ------------------------------------------------------------------------------------------ */
+
+        vk::RenderSystem render_system(device, renderer, pipeline_manager, *global_set_layout);
+        vk::TextureRenderSystem texture_render_system(device, renderer, pipeline_manager, set_layouts);
+        vk::PointLightSystem point_light_system(device, renderer, pipeline_manager, *global_set_layout);
+
+        // Frames rendered before the pipelines are ready draw nothing and would skew the results
+        pipeline_manager.waitIdle();
+
+        vk::GpuProfiler &gpu_profiler = renderer.getGpuProfiler();
+        const std::vector<std::string> system_scopes = {"RenderSystem", "TextureRenderSystem", "PointLightSystem"};
+
+        /* FRAME LOOP --------------------------------------------------------------------------------------- */
+
+        // GPU times are read back frames_in_flight frames late, so the loop runs that much longer to collect
+        // the GPU times of every measured frame
+        const uint32_t first_measured = options.warmup;
+        const uint32_t frame_count = options.warmup + options.frames + frames_in_flight;
+
+        vk::RollingStatistics cpu_frame_times(options.frames);
+        vk::RollingStatistics gpu_frame_times(options.frames);
+        std::map<std::string, vk::RollingStatistics> gpu_scope_times;
+
+        vk::Camera camera;
+
+        // Only submitted frames are counted, a frame lost to swapchain recreation is retried with the same camera
+        uint32_t frame = 0;
+
+        while (frame < frame_count && !window.shouldClose())
+        {
+            const auto frame_start = std::chrono::steady_clock::now();
+
+            window.pollEvents();
+
+            camera.setPerspectiveProjection(vk::Angle::Rad45, renderer.getAspectRatio(), .01f, 1000.f);
+            updateCamera(camera, options, frame, frame_count);
+
+            auto command_buffer = renderer.beginFrame();
+            if (!command_buffer)
+                continue;
+
+            point_light_system.animate(scene, FIXED_DT);
+            scene.updateTransforms();
+
+            // Results of the frame rendered frames_in_flight frames ago, only when they were read back this frame
+            if (frame >= first_measured + frames_in_flight && renderer.isGpuFrameTimeNew())
+            {
+                gpu_frame_times.add(renderer.getGpuFrameTime());
+
+                for (const auto &name : gpu_profiler.getScopeNames())
+                {
+                    auto it = gpu_scope_times.try_emplace(name, options.frames).first;
+                    it->second.add(gpu_profiler.getLastTime(name));
+                }
+            }
+
+            const int frame_index = renderer.getCurrentFrameIndex();
+
+            vk::FrameInfo frame_info{frame_index, FIXED_DT, command_buffer, camera,
+                                     global_descriptor_sets[frame_index], scene, renderer.getFrameStats()};
+
+            vk::CameraUBO ubo = {};
+            ubo.projectionMatrix = camera.getProjectionMatrix();
+            ubo.viewMatrix = camera.getViewMatrix();
+            ubo.inverseViewMatrix = camera.getInverseViewMatrix();
+            ubo.viewProjectionMatrix = ubo.projectionMatrix * ubo.viewMatrix;
+
+            camera_ubo_buffers[frame_index]->write(&ubo, sizeof(ubo));
+            camera_ubo_buffers[frame_index]->flush();
+            frame_info.stats.bytesUploaded += sizeof(ubo);
+
+            point_light_system.update(frame_info, light_clusters);
+
+            if (light_clusters.update(frame_index, camera, renderer.getRenderExtent()))
+                write_global_descriptor_set(frame_index);
+
+            frame_info.stats.bytesUploaded += light_clusters.getUploadedBytes();
+
+            renderer.beginRenderPass(command_buffer);
+
+            {
+                vk::GpuProfiler::Scope scope(gpu_profiler, command_buffer, system_scopes[0]);
+                render_system.render(frame_info);
+            }
+
+            {
+                vk::GpuProfiler::Scope scope(gpu_profiler, command_buffer, system_scopes[1]);
+                texture_render_system.render(frame_info);
+            }
+
+            {
+                vk::GpuProfiler::Scope scope(gpu_profiler, command_buffer, system_scopes[2]);
+                point_light_system.render(frame_info);
+            }
+
+            renderer.endRenderPass(command_buffer);
+            renderer.endFrame();
+
+            if (frame >= first_measured && frame < first_measured + options.frames)
+            {
+                const auto frame_end = std::chrono::steady_clock::now();
+                cpu_frame_times.add(std::chrono::duration<float, std::milli>(frame_end - frame_start).count());
+            }
+
+            ++frame;
+        }
+
+        vkDeviceWaitIdle(device.getLogicalDevice());
+
+        /* REPORT ------------------------------------------------------------------------------------------- */
+
+        Report report;
+        report.deviceName = device.getProperties().deviceName;
+        report.cpuFrameTime = cpu_frame_times.summarize();
+        report.gpuFrameTime = gpu_frame_times.summarize();
+
+        for (const auto &name : gpu_profiler.getScopeNames())
+        {
+            auto it = gpu_scope_times.find(name);
+            if (it != gpu_scope_times.end())
+                report.gpuScopes.emplace_back(name, it->second.summarize());
+
+            // The renderer's own scopes are not counted
+            const auto counters = gpu_profiler.getLastPipelineStatistics(name);
+            if (counters.inputAssemblyVertices > 0)
+                report.pipelineStatistics.emplace_back(name, counters);
+        }
+
+        // Nothing is culled: one draw per mesh and a single instanced draw for all point lights
+        report.meshDraws = scene.getMeshes().size();
+        report.texturedMeshDraws = scene.getTexturedMeshes().size();
+        report.pointLights = scene.getPointLights().size();
+        report.frameStats = renderer.getLastFrameStats();
+
+        std::cout << "CPU frame time: mean " << report.cpuFrameTime.average << " ms, p95 " << report.cpuFrameTime.p95
+                  << " ms, p99 " << report.cpuFrameTime.p99 << " ms" << std::endl;
+        std::cout << "GPU frame time: mean " << report.gpuFrameTime.average << " ms, p95 " << report.gpuFrameTime.p95
+                  << " ms, p99 " << report.gpuFrameTime.p99 << " ms" << std::endl;
+
+        if (!writeReport(options, report, device))
+            return 1;
+
+        std::cout << "Report written to " << options.output << std::endl;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
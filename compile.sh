@@ -1,20 +1,37 @@
 #!/bin/bash
 
-if [[ -d "$1/assets/shaders" && -d "$2/assets/shaders" ]]
-then
-    diff -r -q "$1/assets/shaders" "$2/assets/shaders"
-    differ=$?
+# Compiles every shader whose SPIR-V is missing or older than its source or any shared *.glsl include, next to the
+# source, so a fresh checkout gets its binaries on the first build. Runs before copy_assets.sh copies them to the
+# build directory.
+# Usage: compile.sh <source dir> <build dir> [glslc path]
 
-   if [[ $differ -eq 1 ]]
-   then
-        for i in `find $1/assets/shaders -name "*.vert" -type f`; do
-            echo "Compiling $i to $i.spv"
-            glslc $i -o $i.spv
-        done
+shaders="$1/assets/shaders"
+glslc="${3:-glslc}"
+includes=("$shaders"/*.glsl)
 
-        for i in `find $1/assets/shaders -name "*.frag" -type f`; do
-            echo "Compiling $i to $i.spv"
-            glslc $i -o $i.spv
-        done
+# compile <source> <output> [glslc options]
+compile()
+{
+    local source=$1 output=$2 stale=0
+    shift 2
+
+    [[ ! -f $output || $source -nt $output ]] && stale=1
+    for include in "${includes[@]}"; do
+        [[ -f $include && $include -nt $output ]] && stale=1
+    done
+
+    if (( stale ))
+    then
+        echo "Compiling $source to $output"
+        "$glslc" "$@" "$source" -o "$output" || exit 1
     fi
-fi
+}
+
+for i in "$shaders"/*.vert "$shaders"/*.frag; do
+    compile "$i" "$i.spv"
+done
+
+# Textured variants of the mesh shaders, the plain builds above never reference the texture set
+for i in mesh mesh_gbuffer; do
+    compile "$shaders/$i.frag" "$shaders/${i}_textured.frag.spv" -DTEXTURED
+done
@@ -18,13 +18,45 @@ class App
     void run();
 
   private:
+    // Deferred shades each pixel once, forward keeps MSAA
+    inline static constexpr Swapchain::RenderPath RENDER_PATH = Swapchain::RenderPath::Forward;
+
+    // Without render pass objects swapchain recreation only rebuilds the images
+    inline static constexpr Swapchain::RenderingMode RENDERING_MODE = Swapchain::RenderingMode::Dynamic;
+
+    // How far the CPU may run ahead of the GPU, and how many images the presentation engine gets
+    inline static constexpr uint32_t FRAMES_IN_FLIGHT = Swapchain::DEFAULT_FRAMES_IN_FLIGHT;
+    inline static constexpr uint32_t SWAPCHAIN_IMAGE_COUNT = 3;
+
+    // Frames are paced to the monitor's refresh rate and input is sampled right after the previous frame
+    // was displayed
+    inline static constexpr bool LIMIT_TO_REFRESH_RATE = true;
+    inline static constexpr bool LOW_LATENCY_MODE = true;
+
+    // The scene is rendered below the output resolution when the GPU cannot hold the refresh rate, and
+    // upscaled with some sharpening (needs dynamic rendering)
+    inline static constexpr bool DYNAMIC_RESOLUTION = true;
+    inline static constexpr float UPSCALE_SHARPNESS = .3f;
+
+    // Record writes the input of every frame to INPUT_RECORDING_PATH on exit, Replay plays it back with the
+    // recorded timesteps and exits at its end, so profiling runs of the same flythrough are comparable
+    inline static constexpr InputRecorder::Mode INPUT_MODE = InputRecorder::Mode::Off;
+    inline static const std::string INPUT_RECORDING_PATH = "input_recording.svki";
+
+    // Written on exit when built with SVKE_ENABLE_PROFILING, open in chrome://tracing or Perfetto
+    inline static const std::string CPU_TRACE_PATH = "cpu_trace.json";
+
+    // Also written on exit with SVKE_ENABLE_PROFILING: VMA's state down to every block and allocation
+    inline static const std::string MEMORY_DUMP_PATH = "vma_dump.json";
+
     std::unique_ptr<Window> window;
     std::unique_ptr<Device> device;
     std::unique_ptr<Renderer> renderer;
+    std::unique_ptr<PipelineManager> pipelineManager;
     std::unique_ptr<DescriptorPool> globalPool;
     std::unique_ptr<DescriptorPool> objectTexturePool;
     std::unique_ptr<TextureSampler> textureSampler;
-    Object::Map objects;
+    Scene scene;
 
     void createWindow();
 
@@ -32,6 +64,8 @@ class App
 
     void createRenderer();
 
+    void createPipelineManager();
+
     void createGlobalPool();
 
     void createObjectTexturePool();
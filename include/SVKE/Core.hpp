@@ -2,20 +2,26 @@
 
 #include "SVKE/Core/Graphics/Color.hpp"
 #include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
 #include "SVKE/Core/Graphics/Shader.hpp"
 #include "SVKE/Core/Graphics/Texture.hpp"
 #include "SVKE/Core/Graphics/TextureImage.hpp"
 #include "SVKE/Core/Graphics/TextureSampler.hpp"
 #include "SVKE/Core/Graphics/Vertex.hpp"
+#include "SVKE/Core/Input/InputRecorder.hpp"
 #include "SVKE/Core/Input/Keyboard.hpp"
 #include "SVKE/Core/Input/Mouse.hpp"
 #include "SVKE/Core/Input/MovementController.hpp"
 #include "SVKE/Core/Math/Angle.hpp"
 #include "SVKE/Core/Math/Matrix.hpp"
+#include "SVKE/Core/Math/TransformBatch.hpp"
 #include "SVKE/Core/Math/Vector.hpp"
 #include "SVKE/Core/System/Device.hpp"
 #include "SVKE/Core/System/Memory/Alignment.hpp"
 #include "SVKE/Core/System/Memory/Buffer.hpp"
+#include "SVKE/Core/System/Memory/MemoryStats.hpp"
 #include "SVKE/Core/System/Swapchain.hpp"
 #include "SVKE/Core/System/Window.hpp"
+#include "SVKE/Core/Time/FrameLimiter.hpp"
+#include "SVKE/Core/Time/Profiler.hpp"
 #include "SVKE/Core/Time/Timer.hpp"
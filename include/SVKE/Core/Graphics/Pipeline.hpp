@@ -10,12 +10,39 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 
 namespace vk
 {
 class Pipeline
 {
   public:
+    // Specialization constant values of one shader stage, owned so a Config stays self-contained
+    struct Specialization
+    {
+        std::vector<VkSpecializationMapEntry> entries;
+        std::vector<uint8_t> data;
+
+        // Booleans must be passed as VkBool32
+        template <typename T> Specialization &set(const uint32_t constant_id, const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "SPECIALIZATION CONSTANTS MUST BE TRIVIALLY COPYABLE");
+
+            VkSpecializationMapEntry entry = {};
+            entry.constantID = constant_id;
+            entry.offset = static_cast<uint32_t>(data.size());
+            entry.size = sizeof(T);
+
+            const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+            entries.push_back(entry);
+
+            return *this;
+        }
+
+        inline const bool isEmpty() const { return entries.empty(); }
+    };
+
     struct Config
     {
         Config() = default;
@@ -30,6 +57,7 @@ class Pipeline
         VkPipelineRasterizationStateCreateInfo rasterizationInfo;
         VkPipelineMultisampleStateCreateInfo multisampleInfo;
         VkPipelineColorBlendAttachmentState colorBlendAttachment;
+        std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments; // See setColorAttachmentCount()
         VkPipelineColorBlendStateCreateInfo colorBlendInfo;
         VkPipelineDepthStencilStateCreateInfo depthStencilInfo;
         std::vector<VkDynamicState> dynamicStatesEnable;
@@ -37,6 +65,13 @@ class Pipeline
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
         VkRenderPass renderPass = VK_NULL_HANDLE;
         uint32_t subpass = 0;
+
+        // Dynamic rendering: used instead of renderPass and subpass when renderPass is VK_NULL_HANDLE
+        std::vector<VkFormat> colorAttachmentFormats;
+        VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+        Specialization vertSpecialization;
+        Specialization fragSpecialization;
     };
 
     Pipeline(Device &device, const std::string &vert_path, const std::string &frag_path);
@@ -56,6 +91,10 @@ class Pipeline
 
     static void enableAlphaBlending(Config &config);
 
+    // For subpasses with several color attachments (e.g. the G-buffer). Every attachment gets the current
+    // colorBlendAttachment state, so call it after any blending changes.
+    static void setColorAttachmentCount(Config &config, const uint32_t count);
+
   private:
     Device &device;
     VkPipeline graphicsPipeline;
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/Shader.hpp"
+#include "SVKE/Core/System/Device.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vk
+{
+// Compiles graphics pipelines on worker threads.
+// Requests are keyed by the shaders' SPIR-V and every field of the Config that ends up in the create info, so
+// systems asking for the same variant share one pipeline. A request returns at once; the Handle becomes ready
+// when the worker is done, and callers skip (or substitute) draws until then.
+// Everything the Config references (pipeline layout, render pass) must stay alive until the Handle is ready or
+// wait() returned. Before destroying a layout or render pass, release it so a later object created at the same
+// handle value does not get pipelines built against the old one.
+class PipelineManager
+{
+    struct Entry;
+
+  public:
+    // Identity of a pipeline. The hash only narrows the lookup, keys are compared in full.
+    struct Key
+    {
+        std::shared_ptr<const Shader::SPIRVBinary> vertCode;
+        std::shared_ptr<const Shader::SPIRVBinary> fragCode;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+
+        // Every other Config field that ends up in the create info, each widened to 64 bits
+        std::vector<uint64_t> state;
+
+        size_t hash = 0;
+
+        const bool operator==(const Key &other) const;
+    };
+
+    class Handle
+    {
+      public:
+        Handle() = default;
+
+        const bool isValid() const;
+
+        // Throws the compilation error if compilation failed
+        const bool isReady() const;
+
+        // Blocks until compilation finished, successfully or not. Never throws.
+        void wait() const;
+
+        Pipeline &get() const;
+
+        const Key &getKey() const;
+
+      private:
+        std::shared_ptr<Entry> entry;
+
+        Handle(std::shared_ptr<Entry> entry);
+
+        friend class PipelineManager;
+    };
+
+    // worker_count = 0 picks one less than the number of hardware threads
+    PipelineManager(Device &device, const size_t worker_count = 0);
+    PipelineManager(const PipelineManager &) = delete;
+    PipelineManager &operator=(const PipelineManager &) = delete;
+
+    // Joins the workers, queued requests that have not started are dropped
+    ~PipelineManager();
+
+    // Config is taken by pointer because it points into itself and cannot be copied
+    Handle request(std::shared_ptr<Shader> vert_shader, std::shared_ptr<Shader> frag_shader,
+                   std::unique_ptr<Pipeline::Config> config);
+
+    // Blocks until every queued request has been compiled
+    void waitIdle();
+
+    const size_t getPendingCount();
+
+    // Forget the pipelines built against a layout or render pass about to be destroyed. Handles already
+    // returned stay valid, later requests compile a new pipeline.
+    void releasePipelineLayout(VkPipelineLayout pipeline_layout);
+
+    void releaseRenderPass(VkRenderPass render_pass);
+
+    static Key computeKey(const Shader &vert_shader, const Shader &frag_shader, const Pipeline::Config &config);
+
+  private:
+    struct Entry
+    {
+        Key key;
+
+        std::shared_ptr<Shader> vertShader;
+        std::shared_ptr<Shader> fragShader;
+        std::unique_ptr<Pipeline::Config> config;
+
+        std::unique_ptr<Pipeline> pipeline;
+        std::atomic<bool> ready{false};
+        std::promise<void> promise;
+        std::shared_future<void> done;
+    };
+
+    Device &device;
+
+    // By Key::hash, colliding keys share a bucket
+    std::unordered_multimap<size_t, std::shared_ptr<Entry>> entries;
+    std::deque<std::shared_ptr<Entry>> queue;
+    size_t activeCount;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable queueCondition;
+    std::condition_variable idleCondition;
+    bool stopping;
+
+    void workerLoop();
+
+    void compile(Entry &entry);
+};
+} // namespace vk
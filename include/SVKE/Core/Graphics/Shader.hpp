@@ -9,6 +9,7 @@
 
 #include <SVKE/Core/System/Device.hpp>
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -30,9 +31,17 @@ class Shader
 
     VkShaderModule &getModule();
 
+    // Hash of the SPIR-V code, identifies the shader independently of its module handle
+    const size_t getCodeHash() const;
+
+    // The SPIR-V words, shared so pipeline keys can hold on to them after the shader is destroyed
+    const std::shared_ptr<const SPIRVBinary> &getCode() const;
+
   private:
     Device &device;
     VkShaderModule module;
+    size_t codeHash;
+    std::shared_ptr<const SPIRVBinary> code;
 
     SPIRVBinary readShaderFile(const std::string &path);
 };
@@ -7,6 +7,8 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <iostream>
 
@@ -29,6 +31,10 @@ class Texture
     [[nodiscard]]
     const bool loadFromFile(const std::string &path);
 
+    // Copies width * height RGBA pixels, e.g. a texture generated at runtime
+    [[nodiscard]]
+    const bool loadFromData(const int width, const int height, const unsigned char *rgba_pixels);
+
     [[nodiscard]]
     const int getWidth() const;
 
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vk
+{
+// Records the input of every frame and plays it back.
+// A frame holds its timestep, the cursor deltas and the keys that were queried and found pressed. Keyboard and
+// Mouse feed the recorder while recording and answer from it while replaying, so a replay follows the recorded
+// path frame by frame, with the recorded timesteps, whatever the frame times of the machine replaying it.
+//
+// File layout, in host byte order (little endian on every supported platform): magic "SVKI", version and frame
+// count as uint32, then per frame dt, cursor delta x and y as float, flags and key count as uint8, and the
+// pressed key codes as uint16.
+class InputRecorder
+{
+  public:
+    enum class Mode
+    {
+        Off,
+        Record,
+        Replay,
+    };
+
+    inline static constexpr uint32_t FILE_MAGIC = 0x494b5653; // "SVKI"
+    inline static constexpr uint32_t FILE_VERSION = 1;
+    inline static constexpr size_t MAX_KEYS_PER_FRAME = 255;
+
+    InputRecorder();
+    InputRecorder(const InputRecorder &) = delete;
+    InputRecorder &operator=(const InputRecorder &) = delete;
+
+    // Drops any previous recording
+    void startRecording();
+
+    // Returns false if the file could not be read or is not a recording, the recorder is left off then
+    const bool loadFromFile(const std::string &path);
+
+    // Returns false if the file could not be written
+    const bool saveToFile(const std::string &path) const;
+
+    void stop();
+
+    [[nodiscard]]
+    const Mode getMode() const;
+
+    [[nodiscard]]
+    const bool isRecording() const;
+
+    [[nodiscard]]
+    const bool isReplaying() const;
+
+    // Replaying, true once every recorded frame was handed out
+    [[nodiscard]]
+    const bool isFinished() const;
+
+    [[nodiscard]]
+    const size_t getFrameCount() const;
+
+    // Starts the next frame before any input is read and returns the timestep to use for it: dt itself when
+    // off or recording, the recorded timestep when replaying
+    const float beginFrame(const float dt);
+
+    /* CALLED BY THE INPUT CLASSES -------------------------------------------------------------------------- */
+
+    void recordKey(const int key);
+
+    void recordCursor(const float delta_x, const float delta_y, const bool raw_mode);
+
+    [[nodiscard]]
+    const bool isKeyPressed(const int key) const;
+
+    [[nodiscard]]
+    const float getCursorDeltaX() const;
+
+    [[nodiscard]]
+    const float getCursorDeltaY() const;
+
+    [[nodiscard]]
+    const bool isRawMode() const;
+
+  private:
+    inline static constexpr uint8_t FLAG_RAW_MODE = 1 << 0;
+
+    struct Frame
+    {
+        float dt = 0.f;
+        float cursorDeltaX = 0.f;
+        float cursorDeltaY = 0.f;
+        uint8_t flags = 0;
+        uint8_t keyCount = 0;
+        uint32_t firstKey = 0;
+    };
+
+    Mode mode;
+
+    // The key codes of all frames back to back, each frame points to its range
+    std::vector<Frame> frames;
+    std::vector<uint16_t> keys;
+
+    // Index of the frame being recorded or replayed, -1 before the first beginFrame()
+    int64_t currentFrame;
+
+    [[nodiscard]]
+    const Frame *getCurrentFrame() const;
+};
+} // namespace vk
@@ -6,6 +6,7 @@
 
 #include <GLFW/glfw3.h>
 
+#include "SVKE/Core/Input/InputRecorder.hpp"
 #include "SVKE/Core/System/Window.hpp"
 
 namespace vk
@@ -148,7 +149,11 @@ class Keyboard
 
     const bool wasKeyReleased(const Key &key);
 
+    // Pressed keys are recorded into it, or read back from it when it replays; nullptr detaches it
+    void setInputRecorder(InputRecorder *recorder);
+
   private:
     Window &window;
+    InputRecorder *recorder;
 };
 } // namespace vk
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SVKE/Core/Input/InputRecorder.hpp"
 #include "SVKE/Core/System/Window.hpp"
 
 namespace vk
@@ -36,6 +37,9 @@ class Mouse
 
     void updateCursorData();
 
+    // Cursor deltas are recorded into it, or read back from it when it replays; nullptr detaches it
+    void setInputRecorder(InputRecorder *recorder);
+
     const CursorMode &getCursorMode();
 
     const CursorData &getCursorData();
@@ -50,5 +54,6 @@ class Mouse
     CursorMode mode;
     CursorData data;
     bool rawModeEnabled;
+    InputRecorder *recorder;
 };
 } // namespace vk
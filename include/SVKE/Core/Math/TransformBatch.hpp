@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SVKE/Core/Math/Vector.hpp"
+#include "SVKE/Core/Math/Matrix.hpp"
+
+#include <cstddef>
+
+namespace vk
+{
+// Batched version of Object::TransformComponent's matrix build, for large numbers of dynamic objects.
+// Takes structure-of-arrays translation/rotation/scale and writes world and normal matrices
+// (translate * Ry * Rx * Rz * scale, and its inverse-scale rotation) 4 (SSE) or 8 (AVX2) objects at a
+// time. The instruction set is picked at runtime, with a scalar fallback on other CPUs.
+class TransformBatch
+{
+  public:
+    enum class Path : int
+    {
+        Scalar = 0,
+        SSE = 1,
+        AVX2 = 2
+    };
+
+    struct Input
+    {
+        const float *translation[3] = {nullptr, nullptr, nullptr}; // x, y, z arrays
+        const float *rotation[3] = {nullptr, nullptr, nullptr};    // x, y, z arrays (radians)
+        const float *scale[3] = {nullptr, nullptr, nullptr};       // x, y, z arrays
+        size_t count = 0;
+    };
+
+    // Uses the best path supported by the running CPU
+    static void compute(const Input &input, Mat4f *world_matrices, Mat3f *normal_matrices);
+
+    static void compute(const Input &input, Mat4f *world_matrices, Mat3f *normal_matrices, const Path &path);
+
+    static const bool isPathSupported(const Path &path);
+
+    static const Path &getPreferredPath();
+
+    static const char *getPathName(const Path &path);
+};
+} // namespace vk
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "SVKE/Core/System/Window.hpp"
+#include "SVKE/Core/System/Memory/MemoryStats.hpp"
 
 #include <vk_mem_alloc.h>
 
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -18,8 +21,17 @@ class Device
 {
   public:
     inline static const std::vector<const char *> VALIDATION_LAYERS = {"VK_LAYER_KHRONOS_validation"};
-    inline static const std::vector<const char *> DEVICE_EXTENSIONS = {VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-                                                                       VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
+    inline static const std::vector<const char *> DEVICE_EXTENSIONS = {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
+
+    // Required unless the window is headless
+    inline static const std::vector<const char *> SWAPCHAIN_EXTENSIONS = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+    // Optional, enabled together when the device supports both
+    inline static const std::vector<const char *> PRESENT_WAIT_EXTENSIONS = {VK_KHR_PRESENT_ID_EXTENSION_NAME,
+                                                                            VK_KHR_PRESENT_WAIT_EXTENSION_NAME};
+
+    // Relative to the working directory, like the assets
+    inline static const std::string DEFAULT_PIPELINE_CACHE_PATH = "pipeline_cache.bin";
 
     struct SwapchainSupportDetails
     {
@@ -46,7 +58,11 @@ class Device
         x64 = VK_SAMPLE_COUNT_64_BIT
     };
 
-    Device(Window &window, const MSAA &preferred_msaa_samples = MSAA::x1);
+    // The pipeline cache is loaded from pipeline_cache_path and written back on destruction.
+    // An empty path keeps the cache in memory only.
+    // With a headless window no surface is created and presentation is not required of the device.
+    Device(Window &window, const MSAA &preferred_msaa_samples = MSAA::x1,
+           const std::string &pipeline_cache_path = DEFAULT_PIPELINE_CACHE_PATH);
 
     Device(const Device &) = delete;
     Device &operator=(const Device &) = delete;
@@ -61,10 +77,18 @@ class Device
 
     VkDevice getLogicalDevice();
 
+    // VK_NULL_HANDLE when headless
     VkSurfaceKHR getSurface();
 
     VkCommandPool getCommandPool();
 
+    // Passed to every pipeline creation
+    VkPipelineCache getPipelineCache();
+
+    // Writes the pipeline cache to a temporary file and renames it over the cache file, so a crash
+    // mid-write never leaves a truncated cache behind. Returns false on failure.
+    const bool savePipelineCache();
+
     VkQueue getGraphicsQueue();
 
     VkQueue getPresentQueue();
@@ -75,6 +99,22 @@ class Device
 
     const VkSampleCountFlagBits &getCurrentMsaaSamples() const;
 
+    // Created for a headless window, there is no surface to present to
+    const bool isHeadless() const;
+
+    // Vulkan 1.3 dynamic rendering, enabled on the logical device when the physical device has it
+    const bool supportsDynamicRendering() const;
+
+    // VK_KHR_present_id and VK_KHR_present_wait, lets the swapchain wait until a given present was displayed
+    const bool supportsPresentWait() const;
+
+    // pipelineStatisticsQuery, enabled when the physical device has it so GpuProfiler can count shader work
+    const bool supportsPipelineStatistics() const;
+
+    // Bits of a timestamp written on the graphics queue that hold the counter, the rest are garbage.
+    // 0 if the queue cannot write timestamps.
+    const uint32_t getGraphicsTimestampValidBits() const;
+
     VkSampleCountFlagBits getMsaaSamplesOrClosest(const MSAA &samples) const;
 
     QueueFamilyIndices findPhysicalQueueFamilies();
@@ -86,9 +126,26 @@ class Device
 
     void endSingleTimeCommands(VkCommandBuffer command_buffer);
 
+    // The allocation is tracked under the category its usage maps to
     void createImageWithInfo(const VkImageCreateInfo &image_info, VkMemoryPropertyFlags properties, VkImage &image,
                              VmaAllocation &image_memory);
 
+    // Untracks and destroys an image whose allocation is tracked
+    void destroyImage(VkImage image, VmaAllocation allocation);
+
+    // Counts allocation towards category in getMemoryStats() and names it after it in the VMA JSON dump
+    void trackAllocation(VmaAllocation allocation, const MemoryCategory &category);
+
+    // Must be called before a tracked allocation is freed, does nothing for untracked ones
+    void untrackAllocation(VmaAllocation allocation);
+
+    // Heap usage against budget, VMA's pools with their fragmentation, and the tracked categories
+    const MemoryStats getMemoryStats() const;
+
+    // Writes VMA's complete state, down to every block and allocation, as JSON. Returns false if the file could
+    // not be written.
+    const bool writeMemoryJson(const std::string &path) const;
+
     static const std::string getMsaaSamplesAsString(const MSAA &samples);
 
   private:
@@ -104,10 +161,22 @@ class Device
     VkQueue presentQueue;
     VmaAllocator allocator;
     VkCommandPool commandPool;
+    VkPipelineCache pipelineCache;
+
+    std::string pipelineCachePath;
 
     VkSampleCountFlagBits msaaMaxSamples;
     VkSampleCountFlagBits currentMsaaSamples;
 
+    bool dynamicRenderingSupported;
+    bool presentWaitSupported;
+    bool pipelineStatisticsSupported;
+    uint32_t graphicsTimestampValidBits;
+
+    // Updated from any thread that creates or frees buffers and images
+    std::array<std::atomic<uint64_t>, MemoryStats::CATEGORY_COUNT> categoryAllocationCounts;
+    std::array<std::atomic<uint64_t>, MemoryStats::CATEGORY_COUNT> categoryBytes;
+
     void nullifyHandles();
 
     void createInstance();
@@ -124,6 +193,11 @@ class Device
 
     void createCommandPool();
 
+    void createPipelineCache();
+
+    // Checks the header written by the driver, data from another device or driver version is discarded
+    const bool isPipelineCacheCompatible(const std::vector<char> &data) const;
+
     const int rateDeviceSuitability(VkPhysicalDevice physical_device);
 
     const std::vector<const char *> getRequiredExtensions();
@@ -134,6 +208,9 @@ class Device
 
     void checkGflwRequiredInstanceExtensions();
 
+    // DEVICE_EXTENSIONS, plus SWAPCHAIN_EXTENSIONS unless headless
+    const std::vector<const char *> getDeviceExtensions() const;
+
     const bool checkDeviceExtensionSupport(VkPhysicalDevice physical_device);
 
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice physical_device);
@@ -142,6 +219,10 @@ class Device
 
     VkSampleCountFlagBits queryMaxUsableSampleCount(VkPhysicalDevice physical_device);
 
+    const bool queryDynamicRenderingSupport(VkPhysicalDevice physical_device);
+
+    const bool queryPresentWaitSupport(VkPhysicalDevice physical_device);
+
     static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                                                         VkDebugUtilsMessageTypeFlagsEXT messageType,
                                                         const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData,
@@ -30,7 +30,17 @@ class Buffer
 
     void unmap();
 
-    void write(void *data, VkDeviceSize size);
+    // Copies size bytes of data into the mapped memory, starting offset bytes into the buffer
+    void write(const void *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+    // Makes host writes to the range visible to the device, a no-op on host coherent memory
+    void flush(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
+
+    // Copies size bytes out of the mapped memory, starting offset bytes into the buffer
+    void read(void *data, VkDeviceSize size, VkDeviceSize offset = 0) const;
+
+    // Makes device writes to the range visible to the host, a no-op on host coherent memory
+    void invalidate(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
 
     void copyTo(Buffer &other, const VkDeviceSize &size);
 
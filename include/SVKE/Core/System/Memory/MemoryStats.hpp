@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vk
+{
+// What an allocation made through the engine is used for, derived from its buffer or image usage
+enum class MemoryCategory : uint32_t
+{
+    Geometry,    // Vertex, index and indirect buffers
+    Textures,    // Sampled images that are never rendered to
+    Attachments, // Swapchain, depth, MSAA, G-buffer and internal targets
+    Uniforms,    // Uniform and storage buffers
+    Staging,     // Transfer-only buffers
+    Other,
+};
+
+// Snapshot of the device's memory, taken by Device::getMemoryStats
+struct MemoryStats
+{
+    inline static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Other) + 1;
+
+    struct Heap
+    {
+        bool deviceLocal = false;
+        VkDeviceSize size = 0;
+        // Usage and budget of the whole process, as reported by VK_EXT_memory_budget
+        VkDeviceSize usage = 0;
+        VkDeviceSize budget = 0;
+        // What VMA allocated from the heap
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+        VkDeviceSize blockBytes = 0;
+        VkDeviceSize allocationBytes = 0;
+    };
+
+    // VMA's default pool of a memory type, memory types without blocks are left out
+    struct Pool
+    {
+        uint32_t memoryTypeIndex = 0;
+        uint32_t heapIndex = 0;
+        VkMemoryPropertyFlags propertyFlags = 0;
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+        VkDeviceSize blockBytes = 0;
+        VkDeviceSize allocationBytes = 0;
+        uint32_t unusedRangeCount = 0;
+        VkDeviceSize largestUnusedRange = 0;
+        // 0 when the free space of the blocks is one range, towards 1 the more it is scattered
+        float fragmentation = 0.f;
+    };
+
+    struct Category
+    {
+        uint64_t allocationCount = 0;
+        VkDeviceSize bytes = 0;
+    };
+
+    std::vector<Heap> heaps;
+    std::vector<Pool> pools;
+    std::array<Category, CATEGORY_COUNT> categories;
+
+    uint32_t totalAllocationCount = 0;
+    VkDeviceSize totalAllocationBytes = 0;
+    VkDeviceSize totalBlockBytes = 0;
+
+    static const char *getCategoryName(const MemoryCategory category);
+
+    static const MemoryCategory categorizeBuffer(const VkBufferUsageFlags usage);
+
+    static const MemoryCategory categorizeImage(const VkImageUsageFlags usage);
+};
+} // namespace vk
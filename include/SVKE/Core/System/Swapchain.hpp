@@ -17,7 +17,9 @@ namespace vk
 class Swapchain
 {
   public:
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    // Frames the CPU may record ahead of the GPU. Independent of the image count, which only decides how many
+    // images the presentation engine can hold (e.g. three for real triple buffering in Mailbox mode).
+    inline static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
 
     enum class PresentMode : int
     {
@@ -30,9 +32,48 @@ class Swapchain
         VSyncRelaxed = VK_PRESENT_MODE_FIFO_RELAXED_KHR
     };
 
-    Swapchain(Device &device, Window &window, const PresentMode &preferred_present_mode = PresentMode::Mailbox);
+    // Deferred renders a G-buffer (albedo, normal, depth) in GEOMETRY_SUBPASS and shades it in LIGHTING_SUBPASS,
+    // reading it back as input attachments so it can stay in tile memory. It always renders with one sample.
+    enum class RenderPath : int
+    {
+        Forward = 0,
+        Deferred = 1
+    };
+
+    // Dynamic begins rendering straight on the attachments (Vulkan 1.3 dynamic rendering), so no render pass or
+    // framebuffers exist and pipelines only depend on the attachment formats. Forward render path only.
+    enum class RenderingMode : int
+    {
+        RenderPass = 0,
+        Dynamic = 1
+    };
+
+    inline static constexpr uint32_t GEOMETRY_SUBPASS = 0;
+    inline static constexpr uint32_t LIGHTING_SUBPASS = 1;
+
+    inline static constexpr VkFormat GBUFFER_ALBEDO_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    inline static constexpr VkFormat GBUFFER_NORMAL_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+    // Of the offscreen images that stand in for swapchain images on a headless device
+    inline static constexpr VkFormat HEADLESS_IMAGE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
+    // preferred_image_count = 0 asks for one more than the surface minimum, any other value is clamped to what
+    // the surface supports. internal_target adds a sampled color image per swapchain image that the scene is
+    // rendered to instead of the swapchain image (dynamic rendering mode only).
+    // On a headless device no VkSwapchainKHR exists: offscreen images of the window's extent are cycled through
+    // instead (one per frame in flight unless preferred_image_count is given), nothing waits for them to be
+    // acquired and nothing is presented. The present mode is ignored.
+    Swapchain(Device &device, Window &window, const PresentMode &preferred_present_mode = PresentMode::Mailbox,
+              const RenderPath &render_path = RenderPath::Forward,
+              const RenderingMode &rendering_mode = RenderingMode::RenderPass,
+              const uint32_t frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT, const uint32_t preferred_image_count = 0,
+              const bool internal_target = false);
     Swapchain(Device &device, Window &window, std::shared_ptr<Swapchain> &previous,
-              const PresentMode &preferred_present_mode = PresentMode::Mailbox);
+              const PresentMode &preferred_present_mode = PresentMode::Mailbox,
+              const RenderPath &render_path = RenderPath::Forward,
+              const RenderingMode &rendering_mode = RenderingMode::RenderPass,
+              const uint32_t frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT, const uint32_t preferred_image_count = 0,
+              const bool internal_target = false);
     ~Swapchain();
 
     Swapchain(const Swapchain &) = delete;
@@ -42,20 +83,39 @@ class Swapchain
 
     VkResult acquireNextImage(uint32_t &image_index);
 
+    // Blocks until the GPU finished the most recently submitted frame
+    void waitForLastSubmission();
+
+    // Blocks until the most recent present was displayed (VK_KHR_present_wait). Returns false if present wait
+    // is unsupported, nothing was presented yet or the timeout (in nanoseconds) ran out.
+    const bool waitForLastPresent(const uint64_t timeout);
+
     VkFormat findDepthFormat();
 
     const bool compatibleWith(Swapchain &other) const;
 
+    // VK_NULL_HANDLE when headless
     VkSwapchainKHR getHandle();
 
+    const bool isHeadless() const;
+
+    // Layout the images are left in at the end of a frame: PRESENT_SRC, or TRANSFER_SRC when headless so the
+    // rendered image can be copied out
+    const VkImageLayout getFinalLayout() const;
+
     VkFramebuffer getFramebuffer(const int index);
 
+    // VK_NULL_HANDLE in dynamic rendering mode
     VkRenderPass getRenderPass();
 
+    VkImage getImage(const int index);
+
     VkImageView getImageView(const int index);
 
     const size_t getImageCount();
 
+    const uint32_t getFramesInFlight() const;
+
     VkFormat getImageFormat();
 
     VkFormat getDepthFormat();
@@ -68,6 +128,35 @@ class Swapchain
 
     const float getExtentAspectRatio();
 
+    const RenderPath &getRenderPath() const;
+
+    const RenderingMode &getRenderingMode() const;
+
+    // Samples of the attachments pipelines render to (always 1 on the deferred path)
+    const VkSampleCountFlagBits getSampleCount() const;
+
+    const uint32_t getAttachmentCount() const;
+
+    VkImage getDepthImage(const int index);
+
+    VkImageView getDepthImageView(const int index);
+
+    // Multisampled color target of the forward path, only rendered to with MSAA
+    VkImage getColorImage();
+
+    VkImageView getColorImageView();
+
+    const bool hasInternalTarget() const;
+
+    // Same format and extent as the swapchain images, only exists with an internal target
+    VkImage getInternalImage(const int index);
+
+    VkImageView getInternalImageView(const int index);
+
+    VkImageView getAlbedoImageView();
+
+    VkImageView getNormalImageView();
+
   private:
     Device &device;
     Window &window;
@@ -77,7 +166,7 @@ class Swapchain
     VkExtent2D extent;
 
     std::vector<VkFramebuffer> framebuffers;
-    VkRenderPass renderPass;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
 
     std::vector<VkImage> depthImages;
     std::vector<VmaAllocation> depthImageAllocations;
@@ -86,31 +175,72 @@ class Swapchain
     std::vector<VkImage> images;
     std::vector<VkImageView> imageViews;
 
-    VkImage colorImage;
-    VmaAllocation colorImageAllocation;
-    VkImageView colorImageView;
+    // Headless only, the images are owned by the swapchain otherwise
+    std::vector<VmaAllocation> imageAllocations;
+    uint32_t nextHeadlessImage = 0;
+
+    VkImage colorImage = VK_NULL_HANDLE;
+    VmaAllocation colorImageAllocation = VK_NULL_HANDLE;
+    VkImageView colorImageView = VK_NULL_HANDLE;
+
+    RenderPath renderPath;
+    RenderingMode renderingMode;
+
+    // Internal target, one per image like the depth buffers
+    bool internalTarget;
+    std::vector<VkImage> internalImages;
+    std::vector<VmaAllocation> internalImageAllocations;
+    std::vector<VkImageView> internalImageViews;
+
+    // G-buffer, deferred path only
+    VkImage albedoImage = VK_NULL_HANDLE;
+    VmaAllocation albedoImageAllocation = VK_NULL_HANDLE;
+    VkImageView albedoImageView = VK_NULL_HANDLE;
+
+    VkImage normalImage = VK_NULL_HANDLE;
+    VmaAllocation normalImageAllocation = VK_NULL_HANDLE;
+    VkImageView normalImageView = VK_NULL_HANDLE;
 
-    VkSwapchainKHR swapchain;
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
     std::shared_ptr<Swapchain> oldSwapchain;
 
+    uint32_t framesInFlight;
+
+    // Per frame in flight
     std::vector<VkSemaphore> imageAvailableSemaphores;
-    std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
+
+    // Per image: presentation waits on it, so it may only be signaled again once that image is reacquired
+    std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> imagesInFlight;
     size_t currentFrame;
 
-    void init(const PresentMode &preferred_present_mode);
+    // Id given to the last present, 0 before the first one. Only used with present wait.
+    uint64_t presentId = 0;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+
+    void init(const PresentMode &preferred_present_mode, const uint32_t preferred_image_count);
 
-    void createSwapchain(const PresentMode &preferred_present_mode);
+    void createSwapchain(const PresentMode &preferred_present_mode, const uint32_t preferred_image_count);
+
+    void createHeadlessImages(const uint32_t preferred_image_count);
 
     void createImageViews();
 
     void createColorResources();
 
+    void createInternalTargetResources();
+
     void createDepthResources();
 
+    void createGBufferResources();
+
+    void createGBufferImage(const VkFormat format, VkImage &image, VmaAllocation &allocation, VkImageView &view);
+
     void createRenderPass();
 
+    void createDeferredRenderPass();
+
     void createFramebuffers();
 
     void createSyncObjects();
@@ -12,15 +12,22 @@
 
 namespace vk
 {
+// A headless window has no GLFW window or surface behind it, only an extent. Device and Renderer given one
+// render into offscreen images instead of a swapchain, which needs no display (e.g. on lavapipe in CI).
 class Window
 {
   public:
     Window() = default;
-    Window(const int width, const int height, const std::string &title = "Untitled Window");
+    Window(const int width, const int height, const std::string &title = "Untitled Window",
+           const bool headless = false);
     Window(const Window &) = delete;
     Window &operator=(const Window &) = delete;
     ~Window();
 
+    [[nodiscard]]
+    const bool isHeadless() const;
+
+    // Always false when headless
     [[nodiscard]]
     const bool shouldClose() const;
 
@@ -46,6 +53,10 @@ class Window
     [[nodiscard]]
     const bool isFullscreen() const;
 
+    // Of the monitor used for fullscreen, 60 when headless
+    [[nodiscard]]
+    const int getRefreshRate() const;
+
     void setResized(const bool resized);
 
     void setPosition(const int x, const int y);
@@ -66,6 +77,7 @@ class Window
     std::string title;
     bool framebufferResized;
     bool fullscreen;
+    bool headless;
 
     static void framebufferResizedCallback(GLFWwindow *window, int width, int height);
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+
+namespace vk
+{
+// Paces frame starts to a target rate.
+// Sleeping alone overshoots by the scheduler's granularity, so wait() sleeps until SPIN_THRESHOLD before the
+// deadline and spins for the rest. Deadlines advance by a fixed period rather than from the time wait()
+// returned, which keeps the average rate exact; a frame that runs more than a period late resets the
+// schedule instead of letting the following frames catch up in a burst.
+class FrameLimiter
+{
+  public:
+    inline static constexpr std::chrono::microseconds SPIN_THRESHOLD{1500};
+
+    // A target rate of 0 disables limiting
+    FrameLimiter(const float target_rate = 0.f);
+
+    void setTargetRate(const float target_rate);
+
+    [[nodiscard]]
+    const float getTargetRate() const;
+
+    [[nodiscard]]
+    const bool isEnabled() const;
+
+    // Blocks until the next frame is due, returns immediately when disabled
+    void wait();
+
+  private:
+    using clock_t = std::chrono::steady_clock;
+
+    float targetRate;
+    clock_t::duration period;
+    clock_t::time_point deadline;
+};
+} // namespace vk
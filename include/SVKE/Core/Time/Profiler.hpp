@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Zones are compiled in only when SVKE_PROFILING is defined (CMake option SVKE_ENABLE_PROFILING), otherwise
+// the macros expand to nothing and instrumented code pays no cost at all.
+// Zone names must outlive the profiler, in practice they are string literals.
+#ifdef SVKE_PROFILING
+#define SVKE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SVKE_PROFILE_CONCAT(a, b)      SVKE_PROFILE_CONCAT_IMPL(a, b)
+#define SVKE_PROFILE_ZONE(name)        const ::vk::Profiler::Zone SVKE_PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#define SVKE_PROFILE_THREAD(name)      ::vk::Profiler::setThreadName(name)
+#else
+#define SVKE_PROFILE_ZONE(name)   static_cast<void>(0)
+#define SVKE_PROFILE_THREAD(name) static_cast<void>(0)
+#endif
+
+namespace vk
+{
+// CPU zone profiler.
+// Every thread records the zones it closes into its own ring buffer of RING_SIZE events, so recording only
+// takes two clock reads and an uncontended lock; once a ring is full the oldest events are overwritten.
+// Buffers outlive their threads, so worker threads that exit before the capture is written still show up.
+// The recorded events are written as Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+class Profiler
+{
+  public:
+    inline static constexpr size_t RING_SIZE = 1 << 16;
+
+    class Zone
+    {
+      public:
+        Zone(const char *name);
+        Zone(const Zone &) = delete;
+        Zone &operator=(const Zone &) = delete;
+
+        ~Zone();
+
+      private:
+        const char *name;
+        int64_t start;
+    };
+
+    // Recording is on by default, zones opened while it is off are not recorded
+    static void setEnabled(const bool enabled);
+
+    static const bool isEnabled();
+
+    // Names the calling thread in the trace
+    static void setThreadName(const std::string &name);
+
+    // Drops every recorded event
+    static void clear();
+
+    // Returns false if the file could not be written
+    static const bool writeChromeTrace(const std::string &path);
+
+  private:
+    using clock_t = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char *name;
+        int64_t start;
+        int64_t duration;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next = 0;
+        size_t count = 0;
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::atomic<bool> enabled{true};
+        clock_t::time_point epoch = clock_t::now();
+    };
+
+    static Registry &getRegistry();
+
+    static ThreadBuffer &getThreadBuffer();
+
+    // Nanoseconds since the registry was created
+    static const int64_t now();
+
+    static void record(const char *name, const int64_t start, const int64_t end);
+};
+} // namespace vk
@@ -1,13 +1,23 @@
 #pragma once
 
 #include "SVKE/Rendering/Camera.hpp"
+#include "SVKE/Rendering/DynamicResolution.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorPool.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorSet.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorSetLayout.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorWriter.hpp"
+#include "SVKE/Rendering/FrameStats.hpp"
+#include "SVKE/Rendering/Lighting/LightClusters.hpp"
+#include "SVKE/Rendering/Profiling/GpuProfiler.hpp"
 #include "SVKE/Rendering/Resources/Model.hpp"
 #include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Rendering/Scene/ComponentArray.hpp"
+#include "SVKE/Rendering/Scene/Scene.hpp"
+#include "SVKE/Rendering/Scene/SceneGraph.hpp"
+#include "SVKE/Rendering/Systems/DeferredLightingSystem.hpp"
+#include "SVKE/Rendering/Systems/MeshShaderVariant.hpp"
 #include "SVKE/Rendering/Systems/PointLightSystem.hpp"
 #include "SVKE/Rendering/Systems/Renderer.hpp"
 #include "SVKE/Rendering/Systems/RenderSystem.hpp"
 #include "SVKE/Rendering/Systems/TextureRenderSystem.hpp"
+#include "SVKE/Rendering/Systems/UpscaleSystem.hpp"
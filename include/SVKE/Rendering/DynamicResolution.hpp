@@ -0,0 +1,51 @@
+#pragma once
+
+namespace vk
+{
+// Picks the render scale (fraction of the output resolution per axis) that holds a target GPU frame time.
+// GPU time is smoothed first so a single slow frame does not change the resolution. The cost of a frame is
+// taken to be proportional to its pixel count, so the scale that would hit the target is
+// scale * sqrt(target / time); each update moves only part of the way there, and not at all while the time is
+// within the deadband, to keep the image from visibly pumping.
+class DynamicResolution
+{
+  public:
+    struct Config
+    {
+        // In milliseconds
+        float targetFrameTime = 1000.f / 60.f;
+        float minScale = .5f;
+        float maxScale = 1.f;
+        // Weight of the newest sample in the smoothed frame time
+        float smoothing = .1f;
+        // Fraction of the way to the ideal scale covered per update
+        float responsiveness = .25f;
+        // Relative frame time error that is tolerated without rescaling
+        float deadband = .05f;
+    };
+
+    DynamicResolution();
+    DynamicResolution(const Config &config);
+
+    // Feeds the GPU time of a finished frame in milliseconds and returns the scale for the next one
+    const float update(const float gpu_frame_time);
+
+    // Returns to the maximum scale and forgets the measured frame times
+    void reset();
+
+    void setConfig(const Config &config);
+
+    const Config &getConfig() const;
+
+    const float getScale() const;
+
+    // 0 until the first update
+    const float getSmoothedFrameTime() const;
+
+  private:
+    Config config;
+
+    float scale;
+    float smoothedFrameTime;
+};
+} // namespace vk
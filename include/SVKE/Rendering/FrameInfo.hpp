@@ -7,27 +7,21 @@
 #include <GLFW/glfw3.h>
 
 #include "SVKE/Rendering/Camera.hpp"
+#include "SVKE/Rendering/FrameStats.hpp"
+#include "SVKE/Rendering/Lighting/LightClusters.hpp"
 #include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Rendering/Scene/Scene.hpp"
 #include "SVKE/Core/System/Memory/Alignment.hpp"
 
-constexpr int MAX_LIGHTS = 10;
-
 namespace vk
 {
-struct PointLight
-{
-    ALIGNAS_VEC3 Vec3f position{};
-    ALIGNAS_VEC4 Vec4f color{}; // w component is light intensity
-};
-
-struct GlobalUBO
+// Binding 0 of the global descriptor set. Lighting data lives in LightClusters' buffers.
+struct CameraUBO
 {
     ALIGNAS_MAT4 Mat4f projectionMatrix{1.f};
     ALIGNAS_MAT4 Mat4f viewMatrix{1.f};
     ALIGNAS_MAT4 Mat4f inverseViewMatrix{1.f};
-    ALIGNAS_VEC4 Vec4f ambientLightColor{1.f, 1.f, 1.f, .01f}; // w = intensity
-    ALIGNAS_NESTED_UNIFORM PointLight pointLights[MAX_LIGHTS];
-    ALIGNAS_SCLR(int) int numLights;
+    ALIGNAS_MAT4 Mat4f viewProjectionMatrix{1.f}; // projection * view, so vertex shaders do one multiply
 };
 
 struct FrameInfo
@@ -37,7 +31,7 @@ struct FrameInfo
     VkCommandBuffer &commandBuffer;
     Camera &camera;
     VkDescriptorSet &globalDescriptorSet;
-    std::unordered_map<Object::objid_t, VkDescriptorSet> &objectDescriptorSets;
-    Object::Map &objects;
+    Scene &scene;
+    FrameStats &stats;
 };
 } // namespace vk
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vk
+{
+// Counters of the commands recorded for one frame. The Renderer resets them in beginFrame and publishes them
+// in endFrame; systems add what they record through FrameInfo::stats.
+struct FrameStats
+{
+    // Frames begun before this one
+    uint64_t frameNumber = 0;
+
+    uint32_t drawCalls = 0;
+    uint32_t instances = 0;
+    uint64_t triangles = 0;
+
+    uint32_t pipelineBinds = 0;
+    uint32_t descriptorSetBinds = 0;
+    uint32_t pushConstantUpdates = 0;
+
+    // Written from the host into mapped buffers
+    uint64_t bytesUploaded = 0;
+
+    // Objects left out by visibility culling
+    uint32_t culledObjects = 0;
+
+    void addDraw(const uint32_t instance_count, const uint64_t triangles_per_instance)
+    {
+        ++drawCalls;
+        instances += instance_count;
+        triangles += triangles_per_instance * instance_count;
+    }
+};
+} // namespace vk
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "SVKE/Core/Graphics/Color.hpp"
+#include "SVKE/Core/Math/Matrix.hpp"
+#include "SVKE/Core/Math/Vector.hpp"
+#include "SVKE/Core/System/Device.hpp"
+#include "SVKE/Core/System/Memory/Alignment.hpp"
+#include "SVKE/Core/System/Memory/Buffer.hpp"
+#include "SVKE/Rendering/Camera.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace vk
+{
+// Clustered forward lighting.
+// Point lights are uploaded to a storage buffer and binned on the CPU into a view-space froxel grid
+// (GRID_X * GRID_Y screen tiles, GRID_Z exponential depth slices). Each cluster stores an offset and
+// count into a light index list, so fragment shaders only loop over the lights that can reach them.
+// Requires a perspective projection set through Camera::setPerspectiveProjection.
+// Each frame only the ranges that differ from what that frame's buffers last received are written.
+class LightClusters
+{
+  public:
+    inline static constexpr uint32_t GRID_X = 16;
+    inline static constexpr uint32_t GRID_Y = 9;
+    inline static constexpr uint32_t GRID_Z = 24;
+    inline static constexpr uint32_t CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    // Lights binned into one cluster past this many are dropped, the lowest light indices are kept. The shaders'
+    // light loop bound (MeshShaderVariant::maxClusterLights) defaults to the same value.
+    inline static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+
+    // Intensity (after attenuation) below which a light is considered not to contribute
+    inline static constexpr float LIGHT_CUTOFF = .005f;
+
+    // Bindings in the global descriptor set, binding 0 is the camera UBO
+    inline static constexpr uint32_t LIGHTS_BINDING = 1;
+    inline static constexpr uint32_t CLUSTERS_BINDING = 2;
+    inline static constexpr uint32_t LIGHT_INDICES_BINDING = 3;
+    inline static constexpr uint32_t LIGHTING_BINDING = 4;
+
+    // std430 layout
+    struct GpuPointLight
+    {
+        ALIGNAS_VEC4 Vec4f position{}; // w = range
+        ALIGNAS_VEC4 Vec4f color{};    // w = intensity
+    };
+
+    struct Cluster
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    // Data the shaders need to locate their cluster
+    struct GridInfo
+    {
+        ALIGNAS_VEC4 glm::uvec4 dimensions{GRID_X, GRID_Y, GRID_Z, 0}; // w = light count
+        ALIGNAS_VEC4 Vec4f parameters{};                                // x = slice scale, y = slice bias, zw = 1 / extent
+    };
+
+    // Uniform buffer at LIGHTING_BINDING
+    struct LightingUBO
+    {
+        ALIGNAS_VEC4 Vec4f ambientLightColor{1.f, 1.f, 1.f, .01f}; // w = intensity
+        ALIGNAS_NESTED_UNIFORM GridInfo grid;
+    };
+
+    // One set of buffers per frame in flight
+    LightClusters(Device &device, const uint32_t frames_in_flight);
+    LightClusters(const LightClusters &) = delete;
+    LightClusters &operator=(const LightClusters &) = delete;
+
+    // Clears the light list of the frame being built
+    void beginLights();
+
+    void addLight(const Vec3f &position, const Color &color, const float intensity);
+
+    void setAmbientLight(const Color &color, const float intensity);
+
+    // Bins the lights added since beginLights() and uploads everything to the buffers of frame_index.
+    // Returns true if buffers had to grow, in which case that frame's descriptor set must be rewritten.
+    const bool update(const int frame_index, const Camera &camera, const VkExtent2D &extent);
+
+    // Bytes the last update() wrote, only the ranges that changed since the frame's buffers were last written
+    const VkDeviceSize getUploadedBytes() const;
+
+    const GridInfo &getGridInfo() const;
+
+    const size_t getLightCount() const;
+
+    VkDescriptorBufferInfo getLightsDescriptorInfo(const int frame_index);
+
+    VkDescriptorBufferInfo getClustersDescriptorInfo(const int frame_index);
+
+    VkDescriptorBufferInfo getLightIndicesDescriptorInfo(const int frame_index);
+
+    VkDescriptorBufferInfo getLightingDescriptorInfo(const int frame_index);
+
+    // Distance at which intensity / distance² drops below LIGHT_CUTOFF
+    static const float computeLightRange(const Color &color, const float intensity);
+
+  private:
+    struct FrameBuffers
+    {
+        std::unique_ptr<Buffer> lights;
+        std::unique_ptr<Buffer> clusters;
+        std::unique_ptr<Buffer> lightIndices;
+        std::unique_ptr<Buffer> lighting;
+        size_t lightCapacity = 0;
+        size_t indexCapacity = 0;
+
+        // Copies of what the buffers currently hold, compared against to find the ranges to write
+        std::vector<GpuPointLight> uploadedLights;
+        std::vector<Cluster> uploadedClusters;
+        std::vector<uint32_t> uploadedLightIndices;
+    };
+
+    Device &device;
+
+    std::vector<FrameBuffers> frames;
+
+    LightingUBO lighting;
+    VkDeviceSize uploadedBytes;
+
+    std::vector<GpuPointLight> lights;
+    std::vector<Cluster> clusters;
+    std::vector<uint32_t> lightIndices;
+
+    // (cluster, light) pairs produced by binning, sorted into lightIndices by cluster
+    std::vector<std::pair<uint32_t, uint32_t>> assignments;
+
+    void binLights(const Camera &camera);
+
+    const bool reserve(FrameBuffers &frame, const size_t light_count, const size_t index_count);
+
+    std::unique_ptr<Buffer> createBuffer(const size_t size, VkBufferUsageFlags usage);
+};
+} // namespace vk
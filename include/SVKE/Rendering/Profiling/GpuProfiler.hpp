@@ -0,0 +1,161 @@
+#pragma once
+
+#include "SVKE/Core/System/Device.hpp"
+#include "SVKE/Utils/RollingStatistics.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vk
+{
+// Measures named scopes of command buffer recording on the GPU with timestamp queries.
+// Every frame in flight has its own query pool. A frame's results are collected when its slot comes around
+// again, frames_in_flight frames later, by which time the fence of that slot has been waited on, so reading
+// them never stalls. Scopes may nest; a name used several times in one frame is summed. Times are kept in
+// milliseconds per scope name over the last HISTORY_SIZE frames.
+// When the device supports pipeline statistics queries, scopes can also count the shader work they contain.
+// Those queries cannot nest and must begin and end within one subpass, so only the outermost scope asking for
+// them gets one; the renderer's own scopes around whole frames and passes do not ask.
+class GpuProfiler
+{
+  public:
+    // Per frame, scopes past it are not measured
+    inline static constexpr uint32_t MAX_SCOPES = 64;
+
+    // Frames the statistics of a scope are computed over
+    inline static constexpr size_t HISTORY_SIZE = 256;
+
+    // Counted by the pipeline statistics queries, in the order the results are written
+    inline static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+    // Laid out like the query results, one 64 bit counter per bit of PIPELINE_STATISTICS
+    struct PipelineStatistics
+    {
+        uint64_t inputAssemblyVertices = 0;
+        uint64_t inputAssemblyPrimitives = 0;
+        uint64_t vertexShaderInvocations = 0;
+        // Primitives reaching the clipper, and how many came out of it
+        uint64_t clippingInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        // Compared to the pixels covered, shows overdraw
+        uint64_t fragmentShaderInvocations = 0;
+    };
+
+    // Measures its own lifetime
+    class Scope
+    {
+      public:
+        Scope(GpuProfiler &profiler, VkCommandBuffer command_buffer, const std::string &name,
+              const bool pipeline_statistics = true);
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope();
+
+      private:
+        GpuProfiler &profiler;
+        VkCommandBuffer commandBuffer;
+    };
+
+    GpuProfiler(Device &device, const uint32_t frames_in_flight);
+    GpuProfiler(const GpuProfiler &) = delete;
+    GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+    ~GpuProfiler();
+
+    // Must be recorded first, outside of any render pass. Collects the results of the previous frame that used
+    // frame_index and resets its queries. Returns true if new results were collected.
+    const bool beginFrame(VkCommandBuffer command_buffer, const int frame_index);
+
+    // With pipeline_statistics the scope is also counted by a pipeline statistics query, if supported and no
+    // enclosing scope is counted already
+    void beginScope(VkCommandBuffer command_buffer, const std::string &name, const bool pipeline_statistics = true);
+
+    void endScope(VkCommandBuffer command_buffer);
+
+    // False if the device cannot write timestamps on its graphics queue, every call is a no-op then
+    const bool isSupported() const;
+
+    // False if timestamps or pipeline statistics queries are not supported, scopes are only timed then
+    const bool isPipelineStatisticsSupported() const;
+
+    // Empty for scopes that were never measured
+    const RollingStatistics::Summary getStatistics(const std::string &name) const;
+
+    // Time of the scope in the most recently collected frame, 0 if it was never measured
+    const float getLastTime(const std::string &name) const;
+
+    // Summed over the counted instances of the scope in the most recently collected frame that counted it, zero
+    // if it never was
+    const PipelineStatistics getLastPipelineStatistics(const std::string &name) const;
+
+    // In the order the scopes were first seen
+    const std::vector<std::string> &getScopeNames() const;
+
+    // Forgets all measured times
+    void clearStatistics();
+
+  private:
+    inline static constexpr uint32_t DROPPED_SCOPE = ~0u;
+    inline static constexpr uint32_t NO_STATISTICS_QUERY = ~0u;
+
+    struct ScopeQueries
+    {
+        uint32_t scopeId;
+        uint32_t firstQuery;
+        uint32_t statisticsQuery;
+    };
+
+    struct Frame
+    {
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+        VkQueryPool statisticsPool = VK_NULL_HANDLE;
+        std::vector<ScopeQueries> scopes;
+        uint32_t queryCount = 0;
+        uint32_t statisticsQueryCount = 0;
+    };
+
+    Device &device;
+
+    bool supported;
+    bool statisticsSupported;
+    // Nanoseconds per tick
+    float timestampPeriod;
+    // Keeps the valid bits of a timestamp
+    uint64_t timestampMask;
+
+    std::vector<Frame> frames;
+    int currentFrame;
+
+    // Indices into the current frame's scopes, DROPPED_SCOPE for scopes past MAX_SCOPES
+    std::vector<uint32_t> openScopes;
+    // A pipeline statistics query is active in the current frame
+    bool statisticsActive;
+
+    std::unordered_map<std::string, uint32_t> scopeIds;
+    std::vector<std::string> scopeNames;
+    std::vector<RollingStatistics> histories;
+    std::vector<PipelineStatistics> lastStatistics;
+
+    // Reused by collect()
+    std::vector<uint64_t> timestamps;
+    std::vector<float> frameTimes;
+    std::vector<bool> measured;
+    std::vector<PipelineStatistics> statisticsResults;
+    std::vector<PipelineStatistics> frameStatistics;
+    std::vector<bool> counted;
+
+    const uint32_t getScopeId(const std::string &name);
+
+    const bool collect(Frame &frame);
+
+    // Runs with the timestamps, as the same fence covers both
+    void collectPipelineStatistics(Frame &frame);
+};
+} // namespace vk
@@ -52,8 +52,15 @@ class Model
 
     void draw(VkCommandBuffer &command_buffer);
 
+    [[nodiscard]]
+    const uint32_t getTriangleCount() const;
+
     static std::unique_ptr<Model> createCubeModel(Device &device, const glm::vec3 &offset);
 
+    // Merges the identical vertices of a stream that lists one vertex per triangle corner, as an OBJ file does,
+    // into unique vertices and the indices into them. Both outputs are overwritten.
+    static void deduplicate(const VertexArray &stream, VertexArray &vertices, IndexArray &indices);
+
   private:
     Device &device;
 
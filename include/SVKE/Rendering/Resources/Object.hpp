@@ -5,6 +5,7 @@
 #include "SVKE/Core/Graphics/TextureImage.hpp"
 #include "SVKE/Core/Math/Vector.hpp"
 #include "SVKE/Core/Math/Matrix.hpp"
+#include "SVKE/Utils/SlotMap.hpp"
 
 #include <memory>
 #include <optional>
@@ -14,22 +15,55 @@ namespace vk
 class Object
 {
   public:
-    using objid_t = uint32_t;
-    using Map = std::unordered_map<objid_t, Object>;
+    // Objects get an id when added to a Scene, as a generational slot handle
+    using objid_t = SlotHandle::handle_t;
 
-    inline static constexpr uint32_t MAX_OBJ_ID = std::numeric_limits<uint32_t>::max();
+    inline static constexpr objid_t INVALID_OBJ_ID = SlotHandle::INVALID;
 
     struct TransformComponent
     {
-        Vec3f translation{};
-        Vec3f scale{1.f, 1.f, 1.f};
-        Vec3f rotation{};
+      public:
+        const Vec3f &getTranslation() const;
+
+        const Vec3f &getScale() const;
+
+        const Vec3f &getRotation() const;
+
+        void setTranslation(const Vec3f &translation);
+
+        void setScale(const Vec3f &scale);
+
+        void setRotation(const Vec3f &rotation);
+
+        const bool isDirty() const;
+
+        // Set by the setters like isDirty(), but only cleared by the SceneGraph once the change has been
+        // propagated to the world matrices (the local cache may be refreshed earlier by mat4()).
+        const bool isWorldDirty() const;
+
+        void clearWorldDirty();
 
         // Corresponds to: translate * Ry * Rx * Rz * scale transformation
         // Rotation convention uses Tail-Bryan angles with axis order Y(1), X(2), Z(3)
         // More: https://en.wikipedia.org/wiki/Euler_angles#Rotation_matrix
-        Mat4f mat4();
-        Mat3f normalMatrix();
+        // Both matrices are cached and only recomputed after a setter marked the component dirty.
+        const Mat4f &mat4();
+        const Mat3f &normalMatrix();
+
+        // Stores matrices computed elsewhere (e.g. by TransformBatch) and clears the dirty flag
+        void setMatrices(const Mat4f &world_matrix, const Mat3f &normal_matrix);
+
+      private:
+        Vec3f translation{};
+        Vec3f scale{1.f, 1.f, 1.f};
+        Vec3f rotation{};
+
+        Mat4f worldMatrix{1.f};
+        Mat3f normal{1.f};
+        bool dirty = true;
+        bool worldDirty = true;
+
+        void recompute();
     };
 
     struct PointLightComponent
@@ -47,11 +81,9 @@ class Object
 
     void draw(VkCommandBuffer &command_buffer);
 
-    Mat4f transform();
-
-    Mat3f normalMatrix();
+    const Mat4f &transform();
 
-    const objid_t &getId() const;
+    const Mat3f &normalMatrix();
 
     const Color &getColor() const;
 
@@ -87,7 +119,6 @@ class Object
                                  const Color color = COLOR_WHITE);
 
   protected:
-    objid_t id;
     Color color;
     TransformComponent transformComponent;
 
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "SVKE/Utils/SlotMap.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace vk
+{
+// Packed storage for one component type (sparse set).
+// Components live contiguously in insertion order, with a parallel array of owner ids. A sparse
+// table indexed by the id's slot index gives O(1) lookup, and removal swaps the last element into
+// the hole so the dense range never has gaps. Ids are generational slot handles: a stale id whose
+// slot has been reused does not match the stored owner and is reported as absent.
+template <typename T> class ComponentArray
+{
+  public:
+    using objid_t = SlotHandle::handle_t;
+
+    inline static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    ComponentArray() = default;
+    ComponentArray(const ComponentArray &) = delete;
+    ComponentArray &operator=(const ComponentArray &) = delete;
+
+    T &insert(const objid_t id, const T &component)
+    {
+        assert(!has(id) && "COMPONENT ALREADY EXISTS FOR THIS ID");
+
+        const uint32_t slot = SlotHandle::index(id);
+
+        if (slot >= sparse.size())
+            sparse.resize(static_cast<size_t>(slot) + 1, INVALID_INDEX);
+
+        sparse[slot] = static_cast<uint32_t>(components.size());
+        ids.push_back(id);
+        components.push_back(component);
+
+        return components.back();
+    }
+
+    void remove(const objid_t id)
+    {
+        if (!has(id))
+            return;
+
+        const uint32_t slot = SlotHandle::index(id);
+        const uint32_t index = sparse[slot];
+        const uint32_t last = static_cast<uint32_t>(components.size() - 1);
+
+        if (index != last)
+        {
+            components[index] = std::move(components[last]);
+            ids[index] = ids[last];
+            sparse[SlotHandle::index(ids[index])] = index;
+        }
+
+        components.pop_back();
+        ids.pop_back();
+        sparse[slot] = INVALID_INDEX;
+    }
+
+    void clear()
+    {
+        components.clear();
+        ids.clear();
+        sparse.clear();
+    }
+
+    inline const bool has(const objid_t id) const
+    {
+        const uint32_t slot = SlotHandle::index(id);
+        return slot < sparse.size() && sparse[slot] != INVALID_INDEX && ids[sparse[slot]] == id;
+    }
+
+    inline T &get(const objid_t id)
+    {
+        assert(has(id) && "COMPONENT DOES NOT EXIST FOR THIS ID");
+        return components[sparse[SlotHandle::index(id)]];
+    }
+
+    inline const T &get(const objid_t id) const
+    {
+        assert(has(id) && "COMPONENT DOES NOT EXIST FOR THIS ID");
+        return components[sparse[SlotHandle::index(id)]];
+    }
+
+    inline T &operator[](const size_t index) { return components[index]; }
+
+    inline const T &operator[](const size_t index) const { return components[index]; }
+
+    // Id of the owner of the component at dense position index
+    inline const objid_t &getId(const size_t index) const { return ids[index]; }
+
+    inline const size_t size() const { return components.size(); }
+
+    inline const bool empty() const { return components.empty(); }
+
+    inline T *data() { return components.data(); }
+
+    inline typename std::vector<T>::iterator begin() { return components.begin(); }
+
+    inline typename std::vector<T>::iterator end() { return components.end(); }
+
+    inline typename std::vector<T>::const_iterator begin() const { return components.begin(); }
+
+    inline typename std::vector<T>::const_iterator end() const { return components.end(); }
+
+  private:
+    std::vector<T> components;
+    std::vector<objid_t> ids;
+    std::vector<uint32_t> sparse;
+};
+} // namespace vk
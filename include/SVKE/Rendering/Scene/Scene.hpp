@@ -0,0 +1,99 @@
+#pragma once
+
+#include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Rendering/Resources/Model.hpp"
+#include "SVKE/Rendering/Scene/ComponentArray.hpp"
+#include "SVKE/Rendering/Scene/SceneGraph.hpp"
+#include "SVKE/Core/Graphics/Color.hpp"
+#include "SVKE/Core/Graphics/TextureImage.hpp"
+#include "SVKE/Core/Math/TransformBatch.hpp"
+#include "SVKE/Utils/SlotMap.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace vk
+{
+class Scene
+{
+  public:
+    using objid_t = Object::objid_t;
+
+    struct MeshComponent
+    {
+        std::shared_ptr<Model> model;
+    };
+
+    struct TexturedMeshComponent
+    {
+        std::shared_ptr<Model> model;
+        std::shared_ptr<TextureImage> textureImage;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    };
+
+    struct PointLightComponent
+    {
+        Color color;
+        float lightIntensity;
+    };
+
+    Scene() = default;
+    Scene(const Scene &) = delete;
+    Scene &operator=(const Scene &) = delete;
+
+    // Splits the object into its components and returns its id. The object itself is not kept.
+    // Ids are generational handles: after remove() the id no longer resolves, even once its slot is reused.
+    objid_t add(const Object &object);
+
+    void remove(const objid_t id);
+
+    void clear();
+
+    const bool contains(const objid_t id) const;
+
+    const size_t getObjectCount() const;
+
+    // Attaches id to parent, so its transform becomes relative to the parent's world transform.
+    // Pass Object::INVALID_OBJ_ID as parent to detach.
+    void setParent(const objid_t id, const objid_t parent);
+
+    const objid_t getParent(const objid_t id) const;
+
+    // Recomputes the local matrices of every dirty transform in one TransformBatch pass, then propagates
+    // world matrices down the changed subtrees. Call once per frame before rendering.
+    void updateTransforms(const bool parallel = false);
+
+    // Valid after the last updateTransforms()
+    const Mat4f &getWorldMatrix(const objid_t id) const;
+
+    const Mat3f &getNormalMatrix(const objid_t id) const;
+
+    // Every object has a transform, so this slot map doubles as the object id table
+    SlotMap<Object::TransformComponent> &getTransforms();
+
+    ComponentArray<MeshComponent> &getMeshes();
+
+    ComponentArray<TexturedMeshComponent> &getTexturedMeshes();
+
+    ComponentArray<PointLightComponent> &getPointLights();
+
+  private:
+    SlotMap<Object::TransformComponent> transforms;
+    ComponentArray<MeshComponent> meshes;
+    ComponentArray<TexturedMeshComponent> texturedMeshes;
+    ComponentArray<PointLightComponent> pointLights;
+    SceneGraph graph;
+
+    // Scratch storage for updateTransforms(), kept to avoid per-frame allocations
+    struct TransformScratch
+    {
+        std::vector<uint32_t> indices;
+        std::vector<float> soa[9];
+        std::vector<Mat4f> worldMatrices;
+        std::vector<Mat3f> normalMatrices;
+    } transformScratch;
+
+    // Recomputes the local matrices of the dirty transforms
+    void updateLocalMatrices();
+};
+} // namespace vk
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Core/Math/Matrix.hpp"
+#include "SVKE/Utils/SlotMap.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vk
+{
+// Transform hierarchy over the objects of a Scene.
+// Nodes are kept in a flat array sorted by depth, so every parent precedes its children and world
+// matrices can be propagated in one linear pass. Only nodes whose local transform changed, and their
+// descendants, are recomputed. Nodes of the same depth never depend on each other, which lets large
+// levels be split across a pool of worker threads, started by the first parallel update and kept until destruction.
+class SceneGraph
+{
+  public:
+    using objid_t = Object::objid_t;
+
+    // Levels with fewer nodes than this are always updated on the calling thread
+    inline static constexpr size_t PARALLEL_MIN_LEVEL_SIZE = 2048;
+
+    SceneGraph() = default;
+    SceneGraph(const SceneGraph &) = delete;
+    SceneGraph &operator=(const SceneGraph &) = delete;
+
+    // Joins the workers
+    ~SceneGraph();
+
+    // New nodes are roots
+    void addNode(const objid_t id);
+
+    // Children of the removed node become roots, keeping their local transforms
+    void removeNode(const objid_t id);
+
+    void clear();
+
+    // Pass Object::INVALID_OBJ_ID as parent to detach. Throws if the parent would become its own descendant.
+    void setParent(const objid_t id, const objid_t parent);
+
+    const objid_t getParent(const objid_t id) const;
+
+    const bool contains(const objid_t id) const;
+
+    const size_t getNodeCount() const;
+
+    const size_t getDepthCount();
+
+    // Recomputes the world matrices of changed subtrees from the local matrices in transforms
+    void update(SlotMap<Object::TransformComponent> &transforms, const bool parallel = false);
+
+    // World matrices are valid after the last update()
+    const Mat4f &getWorldMatrix(const objid_t id) const;
+
+    const Mat3f &getNormalMatrix(const objid_t id) const;
+
+  private:
+    inline static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    struct Node
+    {
+        objid_t id;
+        objid_t parentId;
+        uint32_t parent; // Position of the parent in nodes, NONE for roots
+        uint32_t depth;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Mat4f> worldMatrices;
+    std::vector<Mat3f> normalMatrices;
+    std::vector<uint8_t> changed;
+
+    std::vector<uint32_t> sparse;      // Slot index -> position in nodes
+    std::vector<uint32_t> levelStarts; // First position of each depth, plus the end
+
+    bool orderDirty = false;
+    bool forceUpdate = false;
+
+    // One level split into chunks, claimed under mutex by the workers and the updating thread
+    struct LevelJob
+    {
+        SlotMap<Object::TransformComponent> *transforms = nullptr;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint32_t chunkSize = 0;
+        uint32_t chunkCount = 0;
+        uint32_t nextChunk = 0;
+        uint32_t doneChunks = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobCondition;
+    std::condition_variable doneCondition;
+    LevelJob job;
+    bool stopping = false;
+
+    const uint32_t positionOf(const objid_t id) const;
+
+    void rebuildOrder();
+
+    void updateRange(SlotMap<Object::TransformComponent> &transforms, const uint32_t begin, const uint32_t end);
+
+    void updateLevelParallel(SlotMap<Object::TransformComponent> &transforms, const uint32_t begin,
+                             const uint32_t end);
+
+    // Runs chunks of the current job until none are left to claim
+    void runChunks(std::unique_lock<std::mutex> &lock);
+
+    void workerLoop();
+};
+} // namespace vk
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
+#include "SVKE/Core/System/Device.hpp"
+#include "SVKE/Rendering/FrameInfo.hpp"
+#include "SVKE/Rendering/Systems/MeshShaderVariant.hpp"
+#include "SVKE/Rendering/Systems/Renderer.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorPool.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorSetLayout.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorWriter.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace vk
+{
+// Lighting subpass of the deferred render path.
+// Shades every pixel once with a full screen triangle, reading albedo, normal and depth written by the
+// geometry subpass as input attachments and looping over the light clusters of the global descriptor set.
+// Requires a Renderer created with Swapchain::RenderPath::Deferred.
+class DeferredLightingSystem
+{
+  public:
+    // Upper bound for the number of swapchain images, one input attachment set is kept per image
+    inline static constexpr uint32_t MAX_SWAPCHAIN_IMAGES = 8;
+
+    DeferredLightingSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
+                           DescriptorSetLayout &global_set_layout);
+    DeferredLightingSystem(const DeferredLightingSystem &) = delete;
+    DeferredLightingSystem &operator=(const DeferredLightingSystem &) = delete;
+
+    ~DeferredLightingSystem();
+
+    // Must be called inside Swapchain::LIGHTING_SUBPASS
+    void render(const FrameInfo &frame_info);
+
+  private:
+    Device &device;
+    PipelineManager &pipelineManager;
+    Renderer &renderer;
+
+    VkPipelineLayout pipelineLayout;
+    PipelineManager::Handle pipeline;
+
+    std::shared_ptr<Shader> vertShader;
+    std::shared_ptr<Shader> fragShader;
+
+    std::unique_ptr<DescriptorSetLayout> inputSetLayout;
+    std::unique_ptr<DescriptorPool> inputPool;
+    std::vector<DescriptorSet> inputSets;
+
+    uint32_t inputSetsGeneration;
+
+    void loadShaders();
+
+    void createInputDescriptors();
+
+    // Points the per image sets at the current swapchain attachments
+    void writeInputDescriptorSets();
+
+    void createPipelineLayout(DescriptorSetLayout &global_set_layout);
+
+    void createPipeline(PipelineManager &pipeline_manager);
+};
+} // namespace vk
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Rendering/Lighting/LightClusters.hpp"
+
+#include <cstdint>
+
+namespace vk
+{
+// Specialization constants of the clustered lighting (clustered_lighting.glsl), shared by mesh.frag and
+// deferred_lighting.frag. mesh_gbuffer.frag has none.
+// Every combination is a separate pipeline built from the same shader modules. Texturing is not one of them: it
+// changes the descriptor sets the shader uses, so it is a separate module (mesh_textured.frag.spv).
+struct MeshShaderVariant
+{
+    inline static constexpr uint32_t SPECULAR_ID = 0;
+    inline static constexpr uint32_t MAX_CLUSTER_LIGHTS_ID = 1;
+    inline static constexpr uint32_t BLINN_TERM_FACTOR_ID = 2;
+
+    bool specular = true;
+    // Upper bound of the per fragment light loop. LightClusters bins up to MAX_LIGHTS_PER_CLUSTER lights into a
+    // cluster, a lower bound is cheaper on crowded clusters but skips the binned lights past it.
+    uint32_t maxClusterLights = LightClusters::MAX_LIGHTS_PER_CLUSTER;
+    float blinnTermFactor = 256.f; // Higher values produce sharper specular highlights
+
+    inline void apply(Pipeline::Specialization &specialization) const
+    {
+        specialization.set<VkBool32>(SPECULAR_ID, specular ? VK_TRUE : VK_FALSE)
+            .set(MAX_CLUSTER_LIGHTS_ID, maxClusterLights)
+            .set(BLINN_TERM_FACTOR_ID, blinnTermFactor);
+    }
+};
+} // namespace vk
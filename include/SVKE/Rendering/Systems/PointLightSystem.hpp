@@ -1,50 +1,121 @@
 #pragma once
 
 #include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
 #include "SVKE/Core/Math/Matrix.hpp"
 #include "SVKE/Core/Math/Vector.hpp"
 #include "SVKE/Core/System/Device.hpp"
 #include "SVKE/Core/System/Memory/Alignment.hpp"
+#include "SVKE/Core/System/Memory/Buffer.hpp"
 #include "SVKE/Rendering/Camera.hpp"
 #include "SVKE/Rendering/FrameInfo.hpp"
+#include "SVKE/Rendering/Lighting/LightClusters.hpp"
 #include "SVKE/Rendering/Resources/Object.hpp"
 #include "SVKE/Rendering/Systems/Renderer.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorSetLayout.hpp"
+#include "SVKE/Utils/RadixSort.hpp"
+
+#include <cstddef>
+#include <vector>
 
 namespace vk
 {
 class PointLightSystem
 {
   public:
-    struct PointLightPushConstant
+    // Per instance vertex data of one billboard
+    struct LightInstance
     {
-        ALIGNAS_VEC3 Vec3f position{};
-        ALIGNAS_VEC4 Vec4f color; // w = intensity
-        ALIGNAS_SCLR(float) float radius;
+        Vec4f position; // w = radius
+        Vec4f color;    // w = intensity
+
+        inline static std::vector<VkVertexInputBindingDescription> getBindingDescriptions()
+        {
+            std::vector<VkVertexInputBindingDescription> binding_descriptions(1);
+
+            binding_descriptions[0].binding = 0;
+            binding_descriptions[0].stride = sizeof(LightInstance);
+            binding_descriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+            return binding_descriptions;
+        }
+
+        inline static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions()
+        {
+            std::vector<VkVertexInputAttributeDescription> attribute_descriptions(2);
+
+            attribute_descriptions[0].binding = 0;
+            attribute_descriptions[0].location = 0;
+            attribute_descriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attribute_descriptions[0].offset = offsetof(LightInstance, position);
+
+            attribute_descriptions[1].binding = 0;
+            attribute_descriptions[1].location = 1;
+            attribute_descriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attribute_descriptions[1].offset = offsetof(LightInstance, color);
+
+            return attribute_descriptions;
+        }
     };
 
-    PointLightSystem(Device &device, Renderer &renderer, DescriptorSetLayout &global_set_layout);
+    struct SortEntry
+    {
+        uint32_t key; // Inverted distance key, so ascending order is back to front
+        uint32_t index;
+    };
+
+    PointLightSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
+                     DescriptorSetLayout &global_set_layout);
     PointLightSystem(const PointLightSystem &) = delete;
     PointLightSystem &operator=(const PointLightSystem &) = delete;
 
     ~PointLightSystem();
 
-    void update(const FrameInfo &frame_info, GlobalUBO &ubo);
+    // Moves the lights, call before Scene::updateTransforms so their world matrices include this frame's motion
+    void animate(Scene &scene, const float dt);
+    // Hands the lights' world positions to light_clusters for binning
+    void update(const FrameInfo &frame_info, LightClusters &light_clusters);
+    // Draws every light billboard, back to front, with one instanced draw
     void render(const FrameInfo &frame_info);
 
+    // One entry per position, keyed by its distance to camera_position, in the order of positions
+    static void computeSortEntries(const Vec3f &camera_position, const std::vector<Vec3f> &positions,
+                                   std::vector<SortEntry> &entries);
+
+    // Orders the indices of positions back to front as seen from camera_position. The sort is stable, so equally
+    // distant positions keep their order. scratch is working memory that can be kept between calls.
+    static void sortBackToFront(const Vec3f &camera_position, const std::vector<Vec3f> &positions,
+                                std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch);
+
   private:
+    struct FrameInstances
+    {
+        std::unique_ptr<Buffer> buffer;
+        size_t capacity = 0;
+    };
+
     Device &device;
+    PipelineManager &pipelineManager;
 
     VkPipelineLayout pipelineLayout;
-    std::unique_ptr<Pipeline> pipeline;
+    PipelineManager::Handle pipeline;
+
+    std::shared_ptr<Shader> vertShader;
+    std::shared_ptr<Shader> fragShader;
 
-    std::unique_ptr<Shader> vertShader;
-    std::unique_ptr<Shader> fragShader;
+    std::vector<FrameInstances> frameInstances;
+
+    std::vector<LightInstance> instances;
+    std::vector<Vec3f> lightPositions;
+    std::vector<SortEntry> sortEntries;
+    std::vector<SortEntry> sortScratch;
 
     void loadShaders();
 
     void createPipelineLayout(DescriptorSetLayout &global_set_layout);
 
-    void createPipeline(VkRenderPass render_pass);
+    void createPipeline(Renderer &renderer, PipelineManager &pipeline_manager);
+
+    void reserveInstances(FrameInstances &frame, const size_t count);
 };
 } // namespace vk
@@ -3,7 +3,14 @@
 #include "SVKE/Core/System/Window.hpp"
 #include "SVKE/Core/System/Device.hpp"
 #include "SVKE/Core/System/Swapchain.hpp"
+#include "SVKE/Core/System/Memory/Buffer.hpp"
 #include "SVKE/Core/Graphics/Color.hpp"
+#include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
+#include "SVKE/Core/Time/FrameLimiter.hpp"
+#include "SVKE/Rendering/DynamicResolution.hpp"
+#include "SVKE/Rendering/FrameStats.hpp"
+#include "SVKE/Rendering/Profiling/GpuProfiler.hpp"
 
 #include <array>
 
@@ -12,44 +19,177 @@ namespace vk
 class Renderer
 {
   public:
+    // Upper bound for the present wait of the low latency mode, in nanoseconds
+    inline static constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100'000'000;
+
+    // GPU profiler scopes recorded by the renderer itself
+    inline static const std::string FRAME_SCOPE = "Frame";
+    inline static const std::string RENDER_PASS_SCOPE = "Render pass";
+    inline static const std::string UPSCALE_PASS_SCOPE = "Upscale pass";
+
+    // Number of published FrameStats kept
+    inline static constexpr size_t FRAME_STATS_HISTORY = 240;
+
+    // Dynamic rendering falls back to render passes if the device lacks it or the deferred path is used.
+    // With a headless window and device frames are rendered to offscreen images and never presented.
     Renderer(Device &device, Window &window,
              const Swapchain::PresentMode &preferred_present_mode = Swapchain::PresentMode::Mailbox,
-             const Color &clear_color = COLOR_BLACK);
+             const Color &clear_color = COLOR_BLACK,
+             const Swapchain::RenderPath &render_path = Swapchain::RenderPath::Forward,
+             const Swapchain::RenderingMode &rendering_mode = Swapchain::RenderingMode::RenderPass,
+             const uint32_t frames_in_flight = Swapchain::DEFAULT_FRAMES_IN_FLIGHT,
+             const uint32_t preferred_image_count = 0);
     Renderer(const Renderer &) = delete;
     Renderer &operator=(const Renderer &) = delete;
 
     ~Renderer();
 
+    // Call before sampling input. Applies the frame rate limit and, in low latency mode, waits until the
+    // previous frame was displayed (or, without present wait, finished on the GPU) so that the input is as
+    // fresh as possible when the frame built from it reaches the screen.
+    void waitForNextFrame();
+
     VkCommandBuffer beginFrame();
 
     void endFrame();
 
+    // Begins the render pass, or dynamic rendering on the current swapchain image. With dynamic resolution the
+    // scene is rendered at getRenderExtent() into the top left corner of the internal target instead.
     void beginRenderPass(VkCommandBuffer &command_buffer);
 
     void endRenderPass(VkCommandBuffer &command_buffer);
 
+    // Dynamic resolution only: begins rendering on the swapchain image, after endRenderPass, so the internal
+    // target can be upscaled to it. No depth attachment is bound.
+    void beginUpscalePass(VkCommandBuffer &command_buffer);
+
+    void endUpscalePass(VkCommandBuffer &command_buffer);
+
+    // Deferred path: moves from the G-buffer subpass to the lighting subpass
+    void nextSubpass(VkCommandBuffer &command_buffer);
+
     const bool isFrameInProgress() const;
 
     const int getCurrentFrameIndex() const;
 
+    // 0 disables the limit
+    void setFrameRateLimit(const float frame_rate);
+
+    const float getFrameRateLimit() const;
+
+    void setLowLatencyMode(const bool enabled);
+
+    const bool isLowLatencyMode() const;
+
+    // Renders the scene into an internal target whose resolution follows the measured GPU frame time. Requires
+    // dynamic rendering and recreates the swapchain, ignored otherwise.
+    void setDynamicResolution(const bool enabled);
+
+    const bool isDynamicResolutionEnabled() const;
+
+    DynamicResolution &getDynamicResolution();
+
+    // 1 without dynamic resolution
+    const float getRenderScale() const;
+
+    // Resolution the scene is rendered at, the swapchain extent without dynamic resolution
+    const VkExtent2D getRenderExtent() const;
+
+    // GPU time between the start and end of the last frame whose queries were read back, in milliseconds.
+    // 0 if the device cannot time its graphics queue.
+    const float getGpuFrameTime() const;
+
+    // Whether the last beginFrame read back a new GPU frame time, getGpuFrameTime repeats the previous one otherwise
+    const bool isGpuFrameTimeNew() const;
+
+    // Times FRAME_SCOPE, RENDER_PASS_SCOPE and UPSCALE_PASS_SCOPE, further scopes can be added between
+    // beginFrame and endFrame
+    GpuProfiler &getGpuProfiler();
+
+    // Counters of the frame being recorded, reset by beginFrame. Hand them to the systems through FrameInfo.
+    FrameStats &getFrameStats();
+
+    // Counters of the last frame that was ended, zero before the first one
+    const FrameStats getLastFrameStats() const;
+
+    // Up to FRAME_STATS_HISTORY ended frames, oldest first
+    const std::vector<FrameStats> getFrameStatsHistory() const;
+
+    // Fixed for the renderer's lifetime, per-frame resources are sized by it
+    const uint32_t getFramesInFlight() const;
+
     VkCommandBuffer &getCurrentCommandBuffer();
 
     VkRenderPass getRenderPass();
 
+    // Points config at what this renderer draws to: the render pass, or the attachment formats when
+    // rendering dynamically. Subpass and G-buffer attachment counts are left to the caller.
+    void setPipelineTarget(Pipeline::Config &config);
+
+    // Render passes dropped when the swapchain is recreated are released from pipeline_manager, so pipelines
+    // are never matched against a destroyed render pass. nullptr (the default) disables it.
+    void setPipelineManager(PipelineManager *pipeline_manager);
+
     const float getAspectRatio() const;
 
+    const VkExtent2D getExtent() const;
+
+    const Swapchain::RenderPath &getRenderPath() const;
+
+    const Swapchain::RenderingMode &getRenderingMode() const;
+
+    const VkSampleCountFlagBits getSampleCount() const;
+
+    const uint32_t getCurrentImageIndex() const;
+
+    // Headless only: waits for the GPU and copies the most recently rendered image into pixels, row by row
+    // without padding, 4 bytes per pixel in Swapchain::HEADLESS_IMAGE_FORMAT. Meant for regression tests.
+    void readLastImage(std::vector<uint8_t> &pixels);
+
+    // Incremented every time the swapchain (and with it every attachment) is recreated
+    const uint32_t getSwapchainGeneration() const;
+
+    Swapchain &getSwapchain();
+
   private:
     Device &device;
     Window &window;
 
     Swapchain::PresentMode preferredPresentMode;
+    Swapchain::RenderPath renderPath;
+    Swapchain::RenderingMode renderingMode;
 
     Color clearColor;
 
+    uint32_t framesInFlight;
+    uint32_t preferredImageCount;
+
+    FrameLimiter frameLimiter;
+    bool lowLatencyMode;
+
+    DynamicResolution dynamicResolution;
+    bool dynamicResolutionEnabled;
+    float renderScale;
+
+    GpuProfiler gpuProfiler;
+    float gpuFrameTime;
+    bool gpuFrameTimeNew;
+
+    // Ring of the last ended frames, nextFrameStats is where the next one goes
+    FrameStats frameStats;
+    std::vector<FrameStats> frameStatsHistory;
+    size_t nextFrameStats;
+    uint64_t frameNumber;
+
     std::unique_ptr<Swapchain> swapchain;
     std::vector<VkCommandBuffer> commandBuffers;
 
+    PipelineManager *pipelineManager;
+
     uint32_t currentImageIndex;
+    // -1 until a frame was submitted to the current swapchain
+    int lastRenderedImage;
+    uint32_t swapchainGeneration;
     int currentFrameIndex;
     bool frameInProgress;
 
@@ -58,5 +198,11 @@ class Renderer
     void freeCommandBuffers();
 
     void recreateSwapchain();
+
+    void beginSwapchainRenderPass(VkCommandBuffer &command_buffer);
+
+    void beginDynamicRendering(VkCommandBuffer &command_buffer);
+
+    void setViewportAndScissor(VkCommandBuffer &command_buffer, const VkExtent2D &extent);
 };
 } // namespace vk
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
 #include "SVKE/Core/System/Device.hpp"
 #include "SVKE/Core/System/Memory/Alignment.hpp"
 #include "SVKE/Rendering/Camera.hpp"
 #include "SVKE/Rendering/FrameInfo.hpp"
 #include "SVKE/Rendering/Resources/Object.hpp"
+#include "SVKE/Rendering/Systems/MeshShaderVariant.hpp"
 #include "SVKE/Rendering/Systems/Renderer.hpp"
 #include "SVKE/Rendering/Descriptors/DescriptorSetLayout.hpp"
 
@@ -22,7 +24,8 @@ class TextureRenderSystem
     };
 
   public:
-    TextureRenderSystem(Device &device, Renderer &renderer, std::vector<VkDescriptorSetLayout> &set_layouts);
+    TextureRenderSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
+                        std::vector<VkDescriptorSetLayout> &set_layouts);
     TextureRenderSystem(const TextureRenderSystem &) = delete;
     TextureRenderSystem &operator=(const TextureRenderSystem &) = delete;
 
@@ -32,17 +35,18 @@ class TextureRenderSystem
 
   private:
     Device &device;
+    PipelineManager &pipelineManager;
 
     VkPipelineLayout pipelineLayout;
-    std::unique_ptr<Pipeline> pipeline;
+    PipelineManager::Handle pipeline;
 
-    std::unique_ptr<Shader> vertShader;
-    std::unique_ptr<Shader> fragShader;
+    std::shared_ptr<Shader> vertShader;
+    std::shared_ptr<Shader> fragShader;
 
-    void loadShaders();
+    void loadShaders(const Swapchain::RenderPath &render_path);
 
     void createPipelineLayout(std::vector<VkDescriptorSetLayout> &set_layouts);
 
-    void createPipeline(VkRenderPass render_pass);
+    void createPipeline(Renderer &renderer, PipelineManager &pipeline_manager);
 };
 } // namespace vk
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "SVKE/Core/Graphics/Pipeline.hpp"
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
+#include "SVKE/Core/Graphics/TextureSampler.hpp"
+#include "SVKE/Core/Math/Vector.hpp"
+#include "SVKE/Core/System/Device.hpp"
+#include "SVKE/Core/System/Memory/Alignment.hpp"
+#include "SVKE/Rendering/FrameInfo.hpp"
+#include "SVKE/Rendering/Systems/Renderer.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorPool.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorSetLayout.hpp"
+#include "SVKE/Rendering/Descriptors/DescriptorWriter.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace vk
+{
+// Upscale pass of dynamic resolution.
+// Stretches the part of the internal target the scene was rendered to over the swapchain image with a full
+// screen triangle, filtering bilinearly. A positive sharpness adds an unsharp mask (sampled at the internal
+// resolution) to restore some of the detail lost to the lower resolution.
+// Requires a Renderer with dynamic resolution enabled.
+class UpscaleSystem
+{
+    struct PushConstantData
+    {
+        ALIGNAS_VEC2 Vec2f uvScale{1.f};
+        ALIGNAS_VEC2 Vec2f texelSize{0.f};
+        ALIGNAS_SCLR(float) float sharpness{0.f};
+    };
+
+  public:
+    // Upper bound for the number of swapchain images, one sampler set is kept per image
+    inline static constexpr uint32_t MAX_SWAPCHAIN_IMAGES = 8;
+
+    UpscaleSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager);
+    UpscaleSystem(const UpscaleSystem &) = delete;
+    UpscaleSystem &operator=(const UpscaleSystem &) = delete;
+
+    ~UpscaleSystem();
+
+    // Must be called between Renderer::beginUpscalePass and Renderer::endUpscalePass
+    void render(const FrameInfo &frame_info);
+
+    // 0 filters bilinearly, around .5 is a moderate sharpening
+    void setSharpness(const float sharpness);
+
+    const float getSharpness() const;
+
+  private:
+    Device &device;
+    PipelineManager &pipelineManager;
+    Renderer &renderer;
+
+    VkPipelineLayout pipelineLayout;
+    PipelineManager::Handle pipeline;
+
+    std::shared_ptr<Shader> vertShader;
+    std::shared_ptr<Shader> fragShader;
+
+    std::unique_ptr<TextureSampler> sampler;
+
+    std::unique_ptr<DescriptorSetLayout> sourceSetLayout;
+    std::unique_ptr<DescriptorPool> sourcePool;
+    std::vector<DescriptorSet> sourceSets;
+
+    uint32_t sourceSetsGeneration;
+
+    float sharpness;
+
+    void loadShaders();
+
+    void createSampler();
+
+    void createSourceDescriptors();
+
+    // Points the per image sets at the current internal targets
+    void writeSourceDescriptorSets();
+
+    void createPipelineLayout();
+
+    void createPipeline(PipelineManager &pipeline_manager);
+};
+} // namespace vk
@@ -1,3 +1,6 @@
 #pragma once
 
 #include "SVKE/Utils/HashCombine.hpp"
+#include "SVKE/Utils/RadixSort.hpp"
+#include "SVKE/Utils/RollingStatistics.hpp"
+#include "SVKE/Utils/SlotMap.hpp"
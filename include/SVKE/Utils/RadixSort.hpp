@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vk
+{
+// Maps a float to a uint32_t with the same ordering, negative values included
+inline uint32_t radixKey(const float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+// Stable LSD radix sort on a 32 bit key, one byte per pass.
+// Stability means equal keys keep their input order, so sorting values laid out by id gives a (key, id)
+// order without storing the id in the key. Passes where every key has the same byte are skipped.
+// scratch is only used as storage and can be kept between calls to avoid allocations.
+template <typename T, typename KeyFn> void radixSort(std::vector<T> &values, std::vector<T> &scratch, KeyFn key)
+{
+    if (values.size() < 2)
+        return;
+
+    scratch.resize(values.size());
+
+    for (uint32_t shift = 0; shift < 32; shift += 8)
+    {
+        std::array<size_t, 256> counts = {};
+
+        for (const auto &value : values)
+            ++counts[(key(value) >> shift) & 0xFF];
+
+        if (counts[(key(values.front()) >> shift) & 0xFF] == values.size())
+            continue;
+
+        size_t offset = 0;
+        for (auto &count : counts)
+        {
+            const size_t bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+
+        for (const auto &value : values)
+            scratch[counts[(key(value) >> shift) & 0xFF]++] = value;
+
+        values.swap(scratch);
+    }
+}
+} // namespace vk
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace vk
+{
+// Keeps the last `capacity` samples of a measurement in a ring buffer and summarizes them.
+// Percentiles are computed on demand with nth_element over a scratch copy, so adding a sample stays O(1)
+// and only the (rare) readers pay for the summary.
+class RollingStatistics
+{
+  public:
+    struct Summary
+    {
+        size_t count = 0;
+        float last = 0.f;
+        float average = 0.f;
+        float min = 0.f;
+        float max = 0.f;
+        float p50 = 0.f;
+        float p95 = 0.f;
+        float p99 = 0.f;
+    };
+
+    RollingStatistics(const size_t capacity) : samples(capacity), next(0), count(0)
+    {
+        assert(capacity > 0 && "ROLLING STATISTICS NEED ROOM FOR AT LEAST ONE SAMPLE");
+    }
+
+    void add(const float sample)
+    {
+        samples[next] = sample;
+        next = (next + 1) % samples.size();
+        count = std::min(count + 1, samples.size());
+    }
+
+    void clear()
+    {
+        next = 0;
+        count = 0;
+    }
+
+    const size_t getCount() const { return count; }
+
+    // 0 while empty
+    const float getLast() const { return count > 0 ? samples[(next + samples.size() - 1) % samples.size()] : 0.f; }
+
+    const Summary summarize() const
+    {
+        Summary summary = {};
+        summary.count = count;
+
+        if (count == 0)
+            return summary;
+
+        // The ring is only partially filled until it wrapped once, and then the order does not matter
+        scratch.assign(samples.begin(), samples.begin() + count);
+
+        double sum = 0.0;
+        for (const float sample : scratch)
+            sum += sample;
+
+        summary.last = getLast();
+        summary.average = static_cast<float>(sum / static_cast<double>(count));
+        summary.min = *std::min_element(scratch.begin(), scratch.end());
+        summary.max = *std::max_element(scratch.begin(), scratch.end());
+        summary.p50 = percentile(.50f);
+        summary.p95 = percentile(.95f);
+        summary.p99 = percentile(.99f);
+
+        return summary;
+    }
+
+  private:
+    std::vector<float> samples;
+    size_t next;
+    size_t count;
+
+    mutable std::vector<float> scratch;
+
+    // Nearest rank over scratch, which is partially reordered
+    const float percentile(const float fraction) const
+    {
+        const size_t rank = std::min(static_cast<size_t>(fraction * static_cast<float>(scratch.size())),
+                                     scratch.size() - 1);
+
+        std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+        return scratch[rank];
+    }
+};
+} // namespace vk
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace vk
+{
+// 32-bit generational handle: low INDEX_BITS select a slot, high GENERATION_BITS tell apart the
+// successive occupants of that slot. A handle outlives its object safely: once the slot is freed
+// its generation is bumped and the old handle no longer resolves.
+class SlotHandle
+{
+  public:
+    using handle_t = uint32_t;
+
+    inline static constexpr uint32_t INDEX_BITS = 20;
+    // A slot serves 4096 occupants. Instead of wrapping back to generation 0, where a handle kept from the first
+    // occupant would resolve again, a slot whose last generation is freed is retired and never reused.
+    inline static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+    inline static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    inline static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    // All ones, never produced by a SlotMap since the last index is never allocated.
+    inline static constexpr handle_t INVALID = std::numeric_limits<handle_t>::max();
+    inline static constexpr uint32_t MAX_SLOTS = INDEX_MASK;
+
+    inline static constexpr handle_t make(const uint32_t index, const uint32_t generation)
+    {
+        return (generation & GENERATION_MASK) << INDEX_BITS | (index & INDEX_MASK);
+    }
+
+    inline static constexpr uint32_t index(const handle_t handle) { return handle & INDEX_MASK; }
+
+    inline static constexpr uint32_t generation(const handle_t handle) { return handle >> INDEX_BITS; }
+};
+
+// Handle-addressed container with O(1) insert, lookup and removal.
+// Values are kept packed for iteration; each slot maps a handle index to the value's dense position.
+// Freed slots are reused through a free list with their generation incremented, until the generation runs out.
+template <typename T> class SlotMap
+{
+  public:
+    using handle_t = SlotHandle::handle_t;
+
+    SlotMap() = default;
+    SlotMap(const SlotMap &) = delete;
+    SlotMap &operator=(const SlotMap &) = delete;
+
+    handle_t insert(const T &value)
+    {
+        uint32_t slot_index;
+
+        if (!freeSlots.empty())
+        {
+            slot_index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            if (slots.size() >= SlotHandle::MAX_SLOTS)
+                throw std::runtime_error("vk::SlotMap::insert: SLOT MAP CAPACITY EXCEEDED");
+
+            slot_index = static_cast<uint32_t>(slots.size());
+            slots.push_back({FREE, 0});
+        }
+
+        Slot &slot = slots[slot_index];
+        slot.denseIndex = static_cast<uint32_t>(values.size());
+
+        values.push_back(value);
+        denseToSlot.push_back(slot_index);
+
+        return SlotHandle::make(slot_index, slot.generation);
+    }
+
+    const bool remove(const handle_t handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        const uint32_t slot_index = SlotHandle::index(handle);
+        const uint32_t dense_index = slots[slot_index].denseIndex;
+        const uint32_t last = static_cast<uint32_t>(values.size() - 1);
+
+        if (dense_index != last)
+        {
+            values[dense_index] = std::move(values[last]);
+            denseToSlot[dense_index] = denseToSlot[last];
+            slots[denseToSlot[dense_index]].denseIndex = dense_index;
+        }
+
+        values.pop_back();
+        denseToSlot.pop_back();
+
+        releaseSlot(slot_index);
+
+        return true;
+    }
+
+    void clear()
+    {
+        for (const uint32_t slot_index : denseToSlot)
+            releaseSlot(slot_index);
+
+        values.clear();
+        denseToSlot.clear();
+    }
+
+    inline const bool contains(const handle_t handle) const
+    {
+        const uint32_t slot_index = SlotHandle::index(handle);
+
+        return slot_index < slots.size() && slots[slot_index].denseIndex != FREE &&
+               slots[slot_index].generation == SlotHandle::generation(handle);
+    }
+
+    inline T &get(const handle_t handle)
+    {
+        assert(contains(handle) && "STALE OR INVALID SLOT MAP HANDLE");
+        return values[slots[SlotHandle::index(handle)].denseIndex];
+    }
+
+    inline const T &get(const handle_t handle) const
+    {
+        assert(contains(handle) && "STALE OR INVALID SLOT MAP HANDLE");
+        return values[slots[SlotHandle::index(handle)].denseIndex];
+    }
+
+    // Returns nullptr for stale or invalid handles
+    inline T *find(const handle_t handle) { return contains(handle) ? &get(handle) : nullptr; }
+
+    inline T &operator[](const size_t index) { return values[index]; }
+
+    inline const T &operator[](const size_t index) const { return values[index]; }
+
+    // Handle of the value at dense position index
+    inline const handle_t getHandle(const size_t index) const
+    {
+        const uint32_t slot_index = denseToSlot[index];
+        return SlotHandle::make(slot_index, slots[slot_index].generation);
+    }
+
+    inline const size_t size() const { return values.size(); }
+
+    inline const bool empty() const { return values.empty(); }
+
+    inline T *data() { return values.data(); }
+
+    inline typename std::vector<T>::iterator begin() { return values.begin(); }
+
+    inline typename std::vector<T>::iterator end() { return values.end(); }
+
+    inline typename std::vector<T>::const_iterator begin() const { return values.begin(); }
+
+    inline typename std::vector<T>::const_iterator end() const { return values.end(); }
+
+  private:
+    inline static constexpr uint32_t FREE = std::numeric_limits<uint32_t>::max();
+
+    struct Slot
+    {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<T> values;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<uint32_t> freeSlots;
+
+    // Retired slots keep FREE and the last generation, so no handle resolves to them
+    void releaseSlot(const uint32_t slot_index)
+    {
+        Slot &slot = slots[slot_index];
+        slot.denseIndex = FREE;
+
+        if (slot.generation == SlotHandle::GENERATION_MASK)
+            return;
+
+        ++slot.generation;
+        freeSlots.push_back(slot_index);
+    }
+};
+} // namespace vk
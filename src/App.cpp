@@ -5,6 +5,7 @@ vk::App::App()
     createWindow();
     createDevice();
     createRenderer();
+    createPipelineManager();
     createGlobalPool();
     createObjectTexturePool();
     createTextureSampler();
@@ -13,10 +14,10 @@ vk::App::App()
 
 void vk::App::run()
 {
-    std::array<std::unique_ptr<Buffer>, Swapchain::MAX_FRAMES_IN_FLIGHT> global_ubo_buffers;
-    for (auto &buffer : global_ubo_buffers)
+    std::vector<std::unique_ptr<Buffer>> camera_ubo_buffers(renderer->getFramesInFlight());
+    for (auto &buffer : camera_ubo_buffers)
     {
-        buffer = std::make_unique<Buffer>(*device, sizeof(GlobalUBO),
+        buffer = std::make_unique<Buffer>(*device, sizeof(CameraUBO),
                                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                           VMA_MEMORY_USAGE_AUTO,
                                           VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
@@ -24,10 +25,18 @@ void vk::App::run()
         buffer->map();
     }
 
+    LightClusters light_clusters(*device, renderer->getFramesInFlight());
+
     // Global Descriptor Set Layout
-    auto global_set_layout = DescriptorSetLayout::Builder(*device)
-                                 .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                                 .build();
+    auto global_set_layout =
+        DescriptorSetLayout::Builder(*device)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+            .addBinding(LightClusters::LIGHTS_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(LightClusters::CLUSTERS_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(LightClusters::LIGHT_INDICES_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                        VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(LightClusters::LIGHTING_BINDING, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .build();
 
     // Object Descriptor Set Layout
     auto object_set_layout = DescriptorSetLayout::Builder(*device)
@@ -37,23 +46,38 @@ void vk::App::run()
     std::vector<VkDescriptorSetLayout> set_layouts = {global_set_layout->getDescriptorSetLayout(),
                                                       object_set_layout->getDescriptorSetLayout()};
 
-    std::vector<VkDescriptorSet> global_descriptor_sets(Swapchain::MAX_FRAMES_IN_FLIGHT);
+    std::vector<VkDescriptorSet> global_descriptor_sets(renderer->getFramesInFlight(), VK_NULL_HANDLE);
+
+    // Also called when the light cluster buffers of a frame grow
+    auto write_global_descriptor_set = [&](const int frame_index) {
+        auto camera_info = camera_ubo_buffers[frame_index]->getDescriptorInfo();
+        auto lights_info = light_clusters.getLightsDescriptorInfo(frame_index);
+        auto clusters_info = light_clusters.getClustersDescriptorInfo(frame_index);
+        auto light_indices_info = light_clusters.getLightIndicesDescriptorInfo(frame_index);
+        auto lighting_info = light_clusters.getLightingDescriptorInfo(frame_index);
+
+        DescriptorWriter writer(*global_set_layout, *globalPool);
+        writer.writeBuffer(0, camera_info)
+            .writeBuffer(LightClusters::LIGHTS_BINDING, lights_info)
+            .writeBuffer(LightClusters::CLUSTERS_BINDING, clusters_info)
+            .writeBuffer(LightClusters::LIGHT_INDICES_BINDING, light_indices_info)
+            .writeBuffer(LightClusters::LIGHTING_BINDING, lighting_info);
+
+        if (global_descriptor_sets[frame_index] == VK_NULL_HANDLE)
+            writer.build(global_descriptor_sets[frame_index]);
+        else
+            writer.overwrite(global_descriptor_sets[frame_index]);
+    };
+
     for (int i = 0; i < global_descriptor_sets.size(); ++i)
-    {
-        auto buffer_info = global_ubo_buffers[i]->getDescriptorInfo();
-        DescriptorWriter(*global_set_layout, *globalPool).writeBuffer(0, buffer_info).build(global_descriptor_sets[i]);
-    }
+        write_global_descriptor_set(i);
 
-    std::unordered_map<Object::objid_t, VkDescriptorSet> object_descriptor_sets;
-    for (auto &[id, object] : objects)
+    for (auto &textured_mesh : scene.getTexturedMeshes())
     {
-        if (!object.getTextureImage())
-            continue;
-
-        auto image_info = object.getTextureImage()->getDescriptorInfo(*textureSampler);
+        auto image_info = textured_mesh.textureImage->getDescriptorInfo(*textureSampler);
         DescriptorWriter(*object_set_layout, *objectTexturePool)
             .writeImage(0, image_info)
-            .build(object_descriptor_sets[id]);
+            .build(textured_mesh.descriptorSet);
     }
 
     Camera camera;
@@ -64,9 +88,33 @@ void vk::App::run()
     Mouse mouse(*window);
     MovementController camera_controller(keyboard, mouse);
 
-    RenderSystem render_system(*device, *renderer, *global_set_layout);
-    TextureRenderSystem texture_render_system(*device, *renderer, set_layouts);
-    PointLightSystem point_light_system(*device, *renderer, *global_set_layout);
+    InputRecorder input_recorder;
+    if (INPUT_MODE == InputRecorder::Mode::Record)
+        input_recorder.startRecording();
+    else if (INPUT_MODE == InputRecorder::Mode::Replay && !input_recorder.loadFromFile(INPUT_RECORDING_PATH))
+        throw std::runtime_error("vk::App::run: FAILED TO LOAD INPUT RECORDING " + INPUT_RECORDING_PATH);
+
+    keyboard.setInputRecorder(&input_recorder);
+    mouse.setInputRecorder(&input_recorder);
+
+    // Pipelines compile in the background, systems draw nothing until theirs is ready
+    RenderSystem render_system(*device, *renderer, *pipelineManager, *global_set_layout);
+    TextureRenderSystem texture_render_system(*device, *renderer, *pipelineManager, set_layouts);
+    PointLightSystem point_light_system(*device, *renderer, *pipelineManager, *global_set_layout);
+
+    std::unique_ptr<DeferredLightingSystem> deferred_lighting_system;
+    if (RENDER_PATH == Swapchain::RenderPath::Deferred)
+        deferred_lighting_system =
+            std::make_unique<DeferredLightingSystem>(*device, *renderer, *pipelineManager, *global_set_layout);
+
+    std::unique_ptr<UpscaleSystem> upscale_system;
+    if (renderer->isDynamicResolutionEnabled())
+    {
+        upscale_system = std::make_unique<UpscaleSystem>(*device, *renderer, *pipelineManager);
+        upscale_system->setSharpness(UPSCALE_SHARPNESS);
+    }
+
+    GpuProfiler &gpu_profiler = renderer->getGpuProfiler();
 
     Timer delta_timer;
 
@@ -80,10 +128,20 @@ void vk::App::run()
         std::cerr << "Mouse raw mode is not supported" << std::endl;
     }
 
-    while (!window->shouldClose())
+    SVKE_PROFILE_THREAD("Main");
+
+    while (!window->shouldClose() && !input_recorder.isFinished())
     {
+        SVKE_PROFILE_ZONE("Frame");
+
+        renderer->waitForNextFrame();
+
         window->pollEvents();
 
+        // Starts the frame's recording before any input is read, replaying it also replaces dt
+        const float dt = input_recorder.beginFrame(glm::min(delta_timer.getElapsedTimeAsSeconds(), 0.25f));
+        delta_timer.restart();
+
         if (keyboard.isKeyPressed(Keyboard::Key::Escape))
             mouse.setCursorMode(Mouse::CursorMode::Normal);
 
@@ -96,46 +154,136 @@ void vk::App::run()
         const float aspect_ratio = renderer->getAspectRatio();
         camera.setPerspectiveProjection(Angle::Rad45, aspect_ratio, .01f, 1000.f);
 
-        const float dt = glm::min(delta_timer.getElapsedTimeAsSeconds(), 0.25f);
-        delta_timer.restart();
-
         mouse.updateCursorData();
         camera_controller.moveInPlaneXZ(dt, viewer);
         camera.setViewYXZ(viewer.getTranslation(), viewer.getRotation());
 
+        point_light_system.animate(scene, dt);
+        scene.updateTransforms();
+
         if (auto command_buffer = renderer->beginFrame())
         {
             auto current_frame_index = renderer->getCurrentFrameIndex();
 
-            FrameInfo frame_info{
-                current_frame_index,    dt,     command_buffer, camera, global_descriptor_sets[current_frame_index],
-                object_descriptor_sets, objects};
+            FrameInfo frame_info{current_frame_index, dt, command_buffer, camera,
+                                 global_descriptor_sets[current_frame_index], scene, renderer->getFrameStats()};
 
             // Update
-            GlobalUBO ubo = {};
+            CameraUBO ubo = {};
             ubo.projectionMatrix = camera.getProjectionMatrix();
             ubo.viewMatrix = camera.getViewMatrix();
             ubo.inverseViewMatrix = camera.getInverseViewMatrix();
+            ubo.viewProjectionMatrix = ubo.projectionMatrix * ubo.viewMatrix;
+
+            camera_ubo_buffers[current_frame_index]->write(&ubo, sizeof(ubo));
+            camera_ubo_buffers[current_frame_index]->flush();
+            frame_info.stats.bytesUploaded += sizeof(ubo);
 
-            point_light_system.update(frame_info, ubo);
+            point_light_system.update(frame_info, light_clusters);
 
-            global_ubo_buffers[current_frame_index]->write((void *)&ubo, sizeof(ubo));
+            // Only writes the light and cluster ranges that changed since this frame's buffers were last used
+            if (light_clusters.update(current_frame_index, camera, renderer->getRenderExtent()))
+                write_global_descriptor_set(current_frame_index);
+
+            frame_info.stats.bytesUploaded += light_clusters.getUploadedBytes();
 
             // Render
             renderer->beginRenderPass(command_buffer);
 
             // Order matters!
-            render_system.render(frame_info);
-            texture_render_system.render(frame_info);
-            point_light_system.render(frame_info);
+            {
+                GpuProfiler::Scope scope(gpu_profiler, command_buffer, "RenderSystem");
+                render_system.render(frame_info);
+            }
+
+            {
+                GpuProfiler::Scope scope(gpu_profiler, command_buffer, "TextureRenderSystem");
+                texture_render_system.render(frame_info);
+            }
+
+            if (deferred_lighting_system)
+            {
+                renderer->nextSubpass(command_buffer);
+
+                GpuProfiler::Scope scope(gpu_profiler, command_buffer, "DeferredLightingSystem");
+                deferred_lighting_system->render(frame_info);
+            }
+
+            {
+                GpuProfiler::Scope scope(gpu_profiler, command_buffer, "PointLightSystem");
+                point_light_system.render(frame_info);
+            }
 
             renderer->endRenderPass(command_buffer);
+
+            if (upscale_system)
+            {
+                renderer->beginUpscalePass(command_buffer);
+
+                {
+                    GpuProfiler::Scope scope(gpu_profiler, command_buffer, "UpscaleSystem");
+                    upscale_system->render(frame_info);
+                }
+
+                renderer->endUpscalePass(command_buffer);
+            }
+
             renderer->endFrame();
         }
 
         if (window->shouldClose())
             std::cout << "Last recorded FPS: " << 1.f / dt << std::endl;
     }
+
+    for (const auto &name : gpu_profiler.getScopeNames())
+    {
+        const auto stats = gpu_profiler.getStatistics(name);
+        std::cout << "GPU " << name << ": avg " << stats.average << " ms, p95 " << stats.p95 << " ms, p99 "
+                  << stats.p99 << " ms" << std::endl;
+
+        if (!gpu_profiler.isPipelineStatisticsSupported())
+            continue;
+
+        const auto counters = gpu_profiler.getLastPipelineStatistics(name);
+        if (counters.inputAssemblyVertices > 0)
+            std::cout << "    vertices " << counters.inputAssemblyVertices << ", vertex shader invocations "
+                      << counters.vertexShaderInvocations << ", clipper primitives in " << counters.clippingInvocations
+                      << " out " << counters.clippingPrimitives << ", fragment shader invocations "
+                      << counters.fragmentShaderInvocations << std::endl;
+    }
+
+    if (input_recorder.isRecording())
+    {
+        if (input_recorder.saveToFile(INPUT_RECORDING_PATH))
+            std::cout << "Input of " << input_recorder.getFrameCount() << " frames recorded to " << INPUT_RECORDING_PATH
+                      << std::endl;
+        else
+            std::cerr << "Failed to write input recording " << INPUT_RECORDING_PATH << std::endl;
+    }
+
+    const MemoryStats memory_stats = device->getMemoryStats();
+
+    for (size_t i = 0; i < memory_stats.heaps.size(); ++i)
+    {
+        const auto &heap = memory_stats.heaps[i];
+        std::cout << "Heap " << i << (heap.deviceLocal ? " (device local)" : "") << ": " << heap.usage / (1 << 20)
+                  << " of " << heap.budget / (1 << 20) << " MiB budget" << std::endl;
+    }
+
+    for (size_t i = 0; i < MemoryStats::CATEGORY_COUNT; ++i)
+    {
+        const auto &category = memory_stats.categories[i];
+        std::cout << MemoryStats::getCategoryName(static_cast<MemoryCategory>(i)) << ": " << category.allocationCount
+                  << " allocations, " << category.bytes / 1024 << " KiB" << std::endl;
+    }
+
+#ifdef SVKE_PROFILING
+    if (Profiler::writeChromeTrace(CPU_TRACE_PATH))
+        std::cout << "CPU trace written to " << CPU_TRACE_PATH << std::endl;
+
+    if (device->writeMemoryJson(MEMORY_DUMP_PATH))
+        std::cout << "Memory dump written to " << MEMORY_DUMP_PATH << std::endl;
+#endif
 }
 
 void vk::App::createWindow()
@@ -150,14 +298,38 @@ void vk::App::createDevice()
 
 void vk::App::createRenderer()
 {
-    renderer = std::make_unique<Renderer>(*device, *window, Swapchain::PresentMode::Immediate);
+    renderer = std::make_unique<Renderer>(*device, *window, Swapchain::PresentMode::Immediate, COLOR_BLACK, RENDER_PATH,
+                                          RENDERING_MODE, FRAMES_IN_FLIGHT, SWAPCHAIN_IMAGE_COUNT);
+
+    if (LIMIT_TO_REFRESH_RATE)
+        renderer->setFrameRateLimit(static_cast<float>(window->getRefreshRate()));
+
+    renderer->setLowLatencyMode(LOW_LATENCY_MODE);
+
+    if (DYNAMIC_RESOLUTION)
+    {
+        // Aims a little below the refresh interval so the CPU side and present still fit in the frame
+        DynamicResolution::Config config{};
+        config.targetFrameTime = .9f * 1000.f / static_cast<float>(window->getRefreshRate());
+        renderer->getDynamicResolution().setConfig(config);
+        renderer->setDynamicResolution(true);
+    }
+}
+
+void vk::App::createPipelineManager()
+{
+    pipelineManager = std::make_unique<PipelineManager>(*device);
+    renderer->setPipelineManager(pipelineManager.get());
 }
 
 void vk::App::createGlobalPool()
 {
+    const uint32_t frames_in_flight = renderer->getFramesInFlight();
+
     globalPool = DescriptorPool::Builder(*device)
-                     .setMaxSets(Swapchain::MAX_FRAMES_IN_FLIGHT)
-                     .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Swapchain::MAX_FRAMES_IN_FLIGHT)
+                     .setMaxSets(frames_in_flight)
+                     .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * frames_in_flight)
+                     .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * frames_in_flight)
                      .build();
 }
 
@@ -198,7 +370,7 @@ void vk::App::loadObjects()
         skull.setTranslation({0.f, 1.f, 0.f});
         skull.setScale({.05f, .05f, .05f});
         skull.setRotation({Angle::Rad90, 0.f, 0.f});
-        objects[skull.getId()] = std::move(skull);
+        scene.add(skull);
     }
 
     std::vector<Color> light_colors{COLOR_RED,  COLOR_ORANGE, COLOR_YELLOW, COLOR_GREEN,
@@ -214,6 +386,6 @@ void vk::App::loadObjects()
             Matrix::rotate(Matrix::identityMat4f(), (i * Angle::Rad360) / light_colors.size(), {0.f, -1.f, 0.f});
 
         point_light.setTranslation(Vec3f(rotate_light * Vec4f(-1.5f, -1.f, -1.5f, 1.f)));
-        objects[point_light.getId()] = std::move(point_light);
+        scene.add(point_light);
     }
 }
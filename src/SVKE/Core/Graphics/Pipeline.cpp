@@ -140,10 +140,33 @@ void vk::Pipeline::enableAlphaBlending(Config &config)
     config.colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 }
 
+void vk::Pipeline::setColorAttachmentCount(Config &config, const uint32_t count)
+{
+    config.colorBlendAttachments.assign(count, config.colorBlendAttachment);
+
+    config.colorBlendInfo.attachmentCount = count;
+    config.colorBlendInfo.pAttachments = config.colorBlendAttachments.data();
+}
+
 void vk::Pipeline::createGraphicsPipeline(const Config &config, Shader &vert_shader, Shader &frag_shader)
 {
     assert(config.pipelineLayout != VK_NULL_HANDLE && "PIPELINE LAYOUT WAS NOT PROVIDED OR IS A VK_NULL_HANDLE");
-    assert(config.renderPass != VK_NULL_HANDLE && "PIPELINE RENDER PASS WAS NOT PROVIDED OR IS A VK_NULL_HANDLE");
+    assert((config.renderPass != VK_NULL_HANDLE || !config.colorAttachmentFormats.empty() ||
+            config.depthAttachmentFormat != VK_FORMAT_UNDEFINED) &&
+           "PIPELINE NEEDS A RENDER PASS OR DYNAMIC RENDERING ATTACHMENT FORMATS");
+
+    // Stages without constants keep the values declared in the shader
+    const auto make_specialization_info = [](const Specialization &specialization) {
+        VkSpecializationInfo info = {};
+        info.mapEntryCount = static_cast<uint32_t>(specialization.entries.size());
+        info.pMapEntries = specialization.entries.data();
+        info.dataSize = specialization.data.size();
+        info.pData = specialization.data.data();
+        return info;
+    };
+
+    const VkSpecializationInfo vert_specialization_info = make_specialization_info(config.vertSpecialization);
+    const VkSpecializationInfo frag_specialization_info = make_specialization_info(config.fragSpecialization);
 
     VkPipelineShaderStageCreateInfo shader_stages[2];
     shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -152,7 +175,8 @@ void vk::Pipeline::createGraphicsPipeline(const Config &config, Shader &vert_sha
     shader_stages[0].pName = "main";
     shader_stages[0].flags = 0;
     shader_stages[0].pNext = nullptr;
-    shader_stages[0].pSpecializationInfo = nullptr;
+    shader_stages[0].pSpecializationInfo =
+        config.vertSpecialization.isEmpty() ? nullptr : &vert_specialization_info;
 
     shader_stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -160,7 +184,8 @@ void vk::Pipeline::createGraphicsPipeline(const Config &config, Shader &vert_sha
     shader_stages[1].pName = "main";
     shader_stages[1].flags = 0;
     shader_stages[1].pNext = nullptr;
-    shader_stages[1].pSpecializationInfo = nullptr;
+    shader_stages[1].pSpecializationInfo =
+        config.fragSpecialization.isEmpty() ? nullptr : &frag_specialization_info;
 
     VkPipelineVertexInputStateCreateInfo vertex_input_info = {};
     auto &attribute_descriptions = config.attributeDescriptions;
@@ -188,10 +213,20 @@ void vk::Pipeline::createGraphicsPipeline(const Config &config, Shader &vert_sha
     pipeline_info.renderPass = config.renderPass;
     pipeline_info.subpass = config.subpass;
 
+    VkPipelineRenderingCreateInfo rendering_info = {};
+    rendering_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    rendering_info.colorAttachmentCount = static_cast<uint32_t>(config.colorAttachmentFormats.size());
+    rendering_info.pColorAttachmentFormats = config.colorAttachmentFormats.data();
+    rendering_info.depthAttachmentFormat = config.depthAttachmentFormat;
+
+    // Ignored by the driver when a render pass is given, so only chained without one
+    if (config.renderPass == VK_NULL_HANDLE)
+        pipeline_info.pNext = &rendering_info;
+
     pipeline_info.basePipelineIndex = -1;
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
 
-    if (vkCreateGraphicsPipelines(device.getLogicalDevice(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr,
+    if (vkCreateGraphicsPipelines(device.getLogicalDevice(), device.getPipelineCache(), 1, &pipeline_info, nullptr,
                                   &graphicsPipeline) != VK_SUCCESS)
         throw std::runtime_error("vk::Pipeline::defaultPipelineConfig: FAILED TO CREATE GRAPHICS PIPELINE");
 }
@@ -0,0 +1,342 @@
+#include "SVKE/Core/Graphics/PipelineManager.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+#include "SVKE/Utils/HashCombine.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+// Widens each value to a 64 bit word of the key, floats by their bit pattern
+template <typename... Args> void appendState(std::vector<uint64_t> &state, const Args &...args)
+{
+    const auto widen = [](const auto &value) -> uint64_t {
+        using T = std::decay_t<decltype(value)>;
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            uint32_t bits = 0;
+            static_assert(sizeof(T) == sizeof(bits), "ONLY FLOATS ARE SUPPORTED");
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        else
+        {
+            return static_cast<uint64_t>(value);
+        }
+    };
+
+    (state.push_back(widen(args)), ...);
+}
+} // namespace
+
+/* KEY -------------------------------------------------------------------------------------------------------- */
+
+const bool vk::PipelineManager::Key::operator==(const Key &other) const
+{
+    const auto same_code = [](const std::shared_ptr<const Shader::SPIRVBinary> &a,
+                              const std::shared_ptr<const Shader::SPIRVBinary> &b) {
+        return a == b || (a && b && *a == *b);
+    };
+
+    return hash == other.hash && pipelineLayout == other.pipelineLayout && renderPass == other.renderPass &&
+           state == other.state && same_code(vertCode, other.vertCode) && same_code(fragCode, other.fragCode);
+}
+
+/* HANDLE ----------------------------------------------------------------------------------------------------- */
+
+vk::PipelineManager::Handle::Handle(std::shared_ptr<Entry> entry) : entry(std::move(entry))
+{
+}
+
+const bool vk::PipelineManager::Handle::isValid() const
+{
+    return entry != nullptr;
+}
+
+const bool vk::PipelineManager::Handle::isReady() const
+{
+    assert(isValid() && "HANDLE DOES NOT REFER TO A PIPELINE");
+
+    if (entry->ready.load(std::memory_order_acquire))
+        return true;
+
+    // Surfaces a failed compilation on the calling thread
+    if (entry->done.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        entry->done.get();
+
+    return false;
+}
+
+void vk::PipelineManager::Handle::wait() const
+{
+    assert(isValid() && "HANDLE DOES NOT REFER TO A PIPELINE");
+
+    entry->done.wait();
+}
+
+vk::Pipeline &vk::PipelineManager::Handle::get() const
+{
+    assert(isValid() && entry->ready.load(std::memory_order_acquire) && "PIPELINE IS NOT READY");
+
+    return *entry->pipeline;
+}
+
+const vk::PipelineManager::Key &vk::PipelineManager::Handle::getKey() const
+{
+    assert(isValid() && "HANDLE DOES NOT REFER TO A PIPELINE");
+
+    return entry->key;
+}
+
+/* MANAGER ---------------------------------------------------------------------------------------------------- */
+
+vk::PipelineManager::PipelineManager(Device &device, const size_t worker_count)
+    : device(device), activeCount(0), stopping(false)
+{
+    const size_t hardware_threads = std::max(2u, std::thread::hardware_concurrency());
+    const size_t count = worker_count == 0 ? hardware_threads - 1 : worker_count;
+
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        workers.emplace_back(&PipelineManager::workerLoop, this);
+}
+
+vk::PipelineManager::~PipelineManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+
+        // Wakes anyone still waiting on a dropped request
+        for (auto &entry : queue)
+            entry->promise.set_exception(std::make_exception_ptr(
+                std::runtime_error("vk::PipelineManager::~PipelineManager: PIPELINE REQUEST WAS DROPPED")));
+
+        queue.clear();
+    }
+
+    queueCondition.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+vk::PipelineManager::Handle vk::PipelineManager::request(std::shared_ptr<Shader> vert_shader,
+                                                         std::shared_ptr<Shader> frag_shader,
+                                                         std::unique_ptr<Pipeline::Config> config)
+{
+    assert(vert_shader && frag_shader && config && "PIPELINE REQUEST IS MISSING SHADERS OR CONFIG");
+
+    Key key = computeKey(*vert_shader, *frag_shader, *config);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const auto range = entries.equal_range(key.hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second->key == key)
+                return Handle(it->second);
+        }
+
+        auto entry = std::make_shared<Entry>();
+        entry->key = std::move(key);
+        entry->vertShader = std::move(vert_shader);
+        entry->fragShader = std::move(frag_shader);
+        entry->config = std::move(config);
+        entry->done = entry->promise.get_future().share();
+
+        entries.emplace(entry->key.hash, entry);
+        queue.push_back(entry);
+
+#ifndef NDEBUG
+        std::cout << "QUEUED PIPELINE " << std::hex << entry->key.hash << std::dec << std::endl;
+#endif
+
+        queueCondition.notify_one();
+
+        return Handle(entry);
+    }
+}
+
+void vk::PipelineManager::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [this]() { return queue.empty() && activeCount == 0; });
+}
+
+const size_t vk::PipelineManager::getPendingCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size() + activeCount;
+}
+
+void vk::PipelineManager::releasePipelineLayout(VkPipelineLayout pipeline_layout)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto it = entries.begin(); it != entries.end();)
+        it = it->second->key.pipelineLayout == pipeline_layout ? entries.erase(it) : std::next(it);
+}
+
+void vk::PipelineManager::releaseRenderPass(VkRenderPass render_pass)
+{
+    // Dynamic rendering pipelines have no render pass, they must not all be dropped
+    if (render_pass == VK_NULL_HANDLE)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto it = entries.begin(); it != entries.end();)
+        it = it->second->key.renderPass == render_pass ? entries.erase(it) : std::next(it);
+}
+
+vk::PipelineManager::Key vk::PipelineManager::computeKey(const Shader &vert_shader, const Shader &frag_shader,
+                                                         const Pipeline::Config &config)
+{
+    // Field by field: the create info structs contain padding and pointers that must not reach the key.
+    // Shaders are identified by their code, module handles can be reused after a shader is destroyed.
+    Key key;
+    key.vertCode = vert_shader.getCode();
+    key.fragCode = frag_shader.getCode();
+    key.pipelineLayout = config.pipelineLayout;
+    key.renderPass = config.renderPass;
+
+    auto &state = key.state;
+
+    // Lists are preceded by their size, so the words of one never shift into the next
+    appendState(state, config.attributeDescriptions.size());
+    for (const auto &attribute : config.attributeDescriptions)
+        appendState(state, attribute.location, attribute.binding, attribute.format, attribute.offset);
+
+    appendState(state, config.bindingDescriptions.size());
+    for (const auto &binding : config.bindingDescriptions)
+        appendState(state, binding.binding, binding.stride, binding.inputRate);
+
+    appendState(state, config.viewportInfo.viewportCount, config.viewportInfo.scissorCount);
+
+    appendState(state, config.inputAssemblyInfo.topology, config.inputAssemblyInfo.primitiveRestartEnable);
+
+    const auto &rasterization = config.rasterizationInfo;
+    appendState(state, rasterization.depthClampEnable, rasterization.rasterizerDiscardEnable,
+                rasterization.polygonMode, rasterization.cullMode, rasterization.frontFace,
+                rasterization.depthBiasEnable, rasterization.depthBiasConstantFactor, rasterization.depthBiasClamp,
+                rasterization.depthBiasSlopeFactor, rasterization.lineWidth);
+
+    const auto &multisample = config.multisampleInfo;
+    appendState(state, multisample.rasterizationSamples, multisample.sampleShadingEnable, multisample.minSampleShading,
+                multisample.alphaToCoverageEnable, multisample.alphaToOneEnable);
+
+    const auto &color_blend = config.colorBlendInfo;
+    appendState(state, color_blend.logicOpEnable, color_blend.logicOp, color_blend.attachmentCount,
+                color_blend.blendConstants[0], color_blend.blendConstants[1], color_blend.blendConstants[2],
+                color_blend.blendConstants[3]);
+
+    for (uint32_t i = 0; i < color_blend.attachmentCount; ++i)
+    {
+        const auto &attachment = color_blend.pAttachments[i];
+        appendState(state, attachment.blendEnable, attachment.srcColorBlendFactor, attachment.dstColorBlendFactor,
+                    attachment.colorBlendOp, attachment.srcAlphaBlendFactor, attachment.dstAlphaBlendFactor,
+                    attachment.alphaBlendOp, attachment.colorWriteMask);
+    }
+
+    const auto &depth_stencil = config.depthStencilInfo;
+    appendState(state, depth_stencil.depthTestEnable, depth_stencil.depthWriteEnable, depth_stencil.depthCompareOp,
+                depth_stencil.depthBoundsTestEnable, depth_stencil.stencilTestEnable, depth_stencil.minDepthBounds,
+                depth_stencil.maxDepthBounds);
+
+    for (const auto &stencil : {depth_stencil.front, depth_stencil.back})
+        appendState(state, stencil.failOp, stencil.passOp, stencil.depthFailOp, stencil.compareOp, stencil.compareMask,
+                    stencil.writeMask, stencil.reference);
+
+    appendState(state, config.dynamicStateInfo.dynamicStateCount);
+    for (uint32_t i = 0; i < config.dynamicStateInfo.dynamicStateCount; ++i)
+        appendState(state, config.dynamicStateInfo.pDynamicStates[i]);
+
+    appendState(state, config.subpass);
+
+    appendState(state, config.colorAttachmentFormats.size(), config.depthAttachmentFormat);
+    for (const auto format : config.colorAttachmentFormats)
+        appendState(state, format);
+
+    for (const auto *specialization : {&config.vertSpecialization, &config.fragSpecialization})
+    {
+        appendState(state, specialization->entries.size());
+
+        for (const auto &entry : specialization->entries)
+            appendState(state, entry.constantID, entry.offset, entry.size);
+
+        for (const auto byte : specialization->data)
+            appendState(state, byte);
+    }
+
+    size_t seed = 0;
+    hashCombine(seed, vert_shader.getCodeHash(), frag_shader.getCodeHash(), key.pipelineLayout, key.renderPass);
+
+    for (const auto word : state)
+        hashCombine(seed, word);
+
+    key.hash = seed;
+
+    return key;
+}
+
+void vk::PipelineManager::workerLoop()
+{
+    SVKE_PROFILE_THREAD("Pipeline worker");
+
+    while (true)
+    {
+        std::shared_ptr<Entry> entry;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueCondition.wait(lock, [this]() { return stopping || !queue.empty(); });
+
+            if (stopping)
+                return;
+
+            entry = std::move(queue.front());
+            queue.pop_front();
+            ++activeCount;
+        }
+
+        compile(*entry);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeCount;
+        }
+
+        idleCondition.notify_all();
+    }
+}
+
+void vk::PipelineManager::compile(Entry &entry)
+{
+    SVKE_PROFILE_ZONE("vk::PipelineManager::compile");
+
+    try
+    {
+        // vkCreateGraphicsPipelines and the device's pipeline cache are safe to use from several threads
+        entry.pipeline = std::make_unique<Pipeline>(device, *entry.vertShader, *entry.fragShader, *entry.config);
+        entry.ready.store(true, std::memory_order_release);
+        entry.promise.set_value();
+    }
+    catch (...)
+    {
+        entry.promise.set_exception(std::current_exception());
+    }
+
+    // Only needed for creation
+    entry.vertShader.reset();
+    entry.fragShader.reset();
+    entry.config.reset();
+}
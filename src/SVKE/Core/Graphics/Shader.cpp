@@ -1,9 +1,21 @@
 #include "SVKE/Core/Graphics/Shader.hpp"
 
-vk::Shader::Shader(Device &device, const std::string &path) : device(device)
+#include "SVKE/Core/Time/Profiler.hpp"
+#include "SVKE/Utils/HashCombine.hpp"
+
+vk::Shader::Shader(Device &device, const std::string &path) : device(device), codeHash(0)
 {
+    SVKE_PROFILE_ZONE("vk::Shader::Shader");
+
     SPIRVBinary spirv_bin = readShaderFile(path);
 
+    // codeSize is in bytes, the binary holds one word per byte read
+    const size_t word_count = spirv_bin.size() / sizeof(uint32_t);
+    code = std::make_shared<const SPIRVBinary>(spirv_bin.begin(), spirv_bin.begin() + word_count);
+
+    for (const auto word : *code)
+        hashCombine(codeHash, word);
+
     VkShaderModuleCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     create_info.codeSize = spirv_bin.size();
@@ -23,6 +35,16 @@ VkShaderModule &vk::Shader::getModule()
     return module;
 }
 
+const size_t vk::Shader::getCodeHash() const
+{
+    return codeHash;
+}
+
+const std::shared_ptr<const vk::Shader::SPIRVBinary> &vk::Shader::getCode() const
+{
+    return code;
+}
+
 vk::Shader::SPIRVBinary vk::Shader::readShaderFile(const std::string &path)
 {
     std::ifstream file(path, std::ios::ate | std::ios::binary);
@@ -1,5 +1,7 @@
 #include "SVKE/Core/Graphics/Texture.hpp"
 
+#include "SVKE/Core/Time/Profiler.hpp"
+
 vk::Texture::Texture() : width(0), height(0), pixels(nullptr), size(0)
 {
 }
@@ -11,6 +13,8 @@ vk::Texture::~Texture()
 
 const bool vk::Texture::loadFromFile(const std::string &path)
 {
+    SVKE_PROFILE_ZONE("vk::Texture::loadFromFile");
+
     pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
     size = width * height * 4;
 
@@ -23,6 +27,28 @@ const bool vk::Texture::loadFromFile(const std::string &path)
     return true;
 }
 
+const bool vk::Texture::loadFromData(const int width, const int height, const unsigned char *rgba_pixels)
+{
+    if (width <= 0 || height <= 0 || rgba_pixels == nullptr)
+    {
+        std::cerr << "vk::Texture::loadFromData: INVALID TEXTURE DATA" << std::endl;
+        return false;
+    }
+
+    stbi_image_free(pixels);
+
+    this->width = width;
+    this->height = height;
+    channels = 4;
+    size = static_cast<Size>(width) * height * 4;
+
+    // Freed by stbi_image_free like a loaded image, which releases it with free()
+    pixels = static_cast<Pixels>(std::malloc(size));
+    std::memcpy(pixels, rgba_pixels, size);
+
+    return true;
+}
+
 const int vk::Texture::getWidth() const
 {
     return width;
@@ -1,7 +1,11 @@
 #include "SVKE/Core/Graphics/TextureImage.hpp"
 
+#include "SVKE/Core/Time/Profiler.hpp"
+
 vk::TextureImage::TextureImage(Device &device, Texture &texture) : device(device), format(VK_FORMAT_R8G8B8A8_SRGB)
 {
+    SVKE_PROFILE_ZONE("vk::TextureImage::TextureImage");
+
     createImage(texture, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
     transitionImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
     copyTextureToImage(texture);
@@ -12,7 +16,7 @@ vk::TextureImage::TextureImage(Device &device, Texture &texture) : device(device
 vk::TextureImage::~TextureImage()
 {
     vkDestroyImageView(device.getLogicalDevice(), imageView, nullptr);
-    vmaDestroyImage(device.getAllocator(), image, allocation);
+    device.destroyImage(image, allocation);
 }
 
 const VkDescriptorImageInfo vk::TextureImage::getDescriptorInfo(TextureSampler &sampler) const
@@ -60,6 +64,8 @@ void vk::TextureImage::createImage(Texture &texture, const VkImageTiling tiling,
 
     if (result != VK_SUCCESS)
         throw std::runtime_error("vk::TextureImage::Image: FAILED TO CREATE IMAGE");
+
+    device.trackAllocation(allocation, MemoryStats::categorizeImage(usage));
 }
 
 void vk::TextureImage::transitionImageLayout(const VkImageLayout old_layout, const VkImageLayout new_layout)
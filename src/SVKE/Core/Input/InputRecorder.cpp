@@ -0,0 +1,241 @@
+#include "SVKE/Core/Input/InputRecorder.hpp"
+
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+template <typename T> void writeValue(std::ofstream &file, const T value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> const bool readValue(std::ifstream &file, T &value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+// dt, cursor delta x and y, flags and key count, a frame without keys
+constexpr size_t MIN_FRAME_SIZE = 3 * sizeof(float) + 2 * sizeof(uint8_t);
+} // namespace
+
+vk::InputRecorder::InputRecorder() : mode(Mode::Off), currentFrame(-1)
+{
+}
+
+void vk::InputRecorder::startRecording()
+{
+    frames.clear();
+    keys.clear();
+    currentFrame = -1;
+    mode = Mode::Record;
+}
+
+const bool vk::InputRecorder::loadFromFile(const std::string &path)
+{
+    stop();
+    frames.clear();
+    keys.clear();
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+
+    uint32_t magic = 0, version = 0, frame_count = 0;
+    if (!readValue(file, magic) || !readValue(file, version) || !readValue(file, frame_count) ||
+        magic != FILE_MAGIC || version != FILE_VERSION)
+    {
+        std::cerr << "vk::InputRecorder::loadFromFile: NOT AN INPUT RECORDING: " << path << std::endl;
+        return false;
+    }
+
+    // A corrupt count would otherwise allocate up to 4 billion frames before the reads fail
+    const auto header_end = file.tellg();
+    file.seekg(0, std::ios::end);
+    const auto remaining = static_cast<uint64_t>(file.tellg() - header_end);
+    file.seekg(header_end);
+
+    if (static_cast<uint64_t>(frame_count) * MIN_FRAME_SIZE > remaining)
+    {
+        std::cerr << "vk::InputRecorder::loadFromFile: TRUNCATED INPUT RECORDING: " << path << std::endl;
+        return false;
+    }
+
+    frames.resize(frame_count);
+
+    for (auto &frame : frames)
+    {
+        bool ok = readValue(file, frame.dt) && readValue(file, frame.cursorDeltaX) &&
+                  readValue(file, frame.cursorDeltaY) && readValue(file, frame.flags) &&
+                  readValue(file, frame.keyCount);
+
+        frame.firstKey = static_cast<uint32_t>(keys.size());
+
+        for (uint8_t i = 0; ok && i < frame.keyCount; ++i)
+        {
+            uint16_t key = 0;
+            ok = readValue(file, key);
+            keys.push_back(key);
+        }
+
+        if (!ok)
+        {
+            std::cerr << "vk::InputRecorder::loadFromFile: TRUNCATED INPUT RECORDING: " << path << std::endl;
+            frames.clear();
+            keys.clear();
+            return false;
+        }
+    }
+
+    currentFrame = -1;
+    mode = Mode::Replay;
+
+    return true;
+}
+
+const bool vk::InputRecorder::saveToFile(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+        return false;
+
+    writeValue(file, FILE_MAGIC);
+    writeValue(file, FILE_VERSION);
+    writeValue(file, static_cast<uint32_t>(frames.size()));
+
+    for (const auto &frame : frames)
+    {
+        writeValue(file, frame.dt);
+        writeValue(file, frame.cursorDeltaX);
+        writeValue(file, frame.cursorDeltaY);
+        writeValue(file, frame.flags);
+        writeValue(file, frame.keyCount);
+
+        for (uint32_t i = 0; i < frame.keyCount; ++i)
+            writeValue(file, keys[frame.firstKey + i]);
+    }
+
+    return file.good();
+}
+
+void vk::InputRecorder::stop()
+{
+    mode = Mode::Off;
+}
+
+const vk::InputRecorder::Mode vk::InputRecorder::getMode() const
+{
+    return mode;
+}
+
+const bool vk::InputRecorder::isRecording() const
+{
+    return mode == Mode::Record;
+}
+
+const bool vk::InputRecorder::isReplaying() const
+{
+    return mode == Mode::Replay;
+}
+
+const bool vk::InputRecorder::isFinished() const
+{
+    return mode == Mode::Replay && currentFrame + 1 >= static_cast<int64_t>(frames.size());
+}
+
+const size_t vk::InputRecorder::getFrameCount() const
+{
+    return frames.size();
+}
+
+const float vk::InputRecorder::beginFrame(const float dt)
+{
+    if (mode == Mode::Record)
+    {
+        Frame frame{};
+        frame.dt = dt;
+        frame.firstKey = static_cast<uint32_t>(keys.size());
+        frames.push_back(frame);
+
+        currentFrame = static_cast<int64_t>(frames.size()) - 1;
+        return dt;
+    }
+
+    if (mode == Mode::Replay && !isFinished())
+    {
+        ++currentFrame;
+        return frames[currentFrame].dt;
+    }
+
+    return dt;
+}
+
+void vk::InputRecorder::recordKey(const int key)
+{
+    if (mode != Mode::Record || currentFrame < 0)
+        return;
+
+    // A key is usually queried more than once a frame, it is stored once
+    if (isKeyPressed(key))
+        return;
+
+    Frame &frame = frames[currentFrame];
+
+    // keyCount is a uint8_t, further keys of this frame are not recorded rather than wrapping the count
+    if (frame.keyCount >= MAX_KEYS_PER_FRAME)
+        return;
+
+    keys.push_back(static_cast<uint16_t>(key));
+    ++frame.keyCount;
+}
+
+void vk::InputRecorder::recordCursor(const float delta_x, const float delta_y, const bool raw_mode)
+{
+    if (mode != Mode::Record || currentFrame < 0)
+        return;
+
+    Frame &frame = frames[currentFrame];
+    frame.cursorDeltaX = delta_x;
+    frame.cursorDeltaY = delta_y;
+    frame.flags = raw_mode ? frame.flags | FLAG_RAW_MODE : frame.flags & ~FLAG_RAW_MODE;
+}
+
+const bool vk::InputRecorder::isKeyPressed(const int key) const
+{
+    const Frame *frame = getCurrentFrame();
+    if (frame == nullptr)
+        return false;
+
+    for (uint32_t i = 0; i < frame->keyCount; ++i)
+    {
+        if (keys[frame->firstKey + i] == key)
+            return true;
+    }
+
+    return false;
+}
+
+const float vk::InputRecorder::getCursorDeltaX() const
+{
+    const Frame *frame = getCurrentFrame();
+    return frame != nullptr ? frame->cursorDeltaX : 0.f;
+}
+
+const float vk::InputRecorder::getCursorDeltaY() const
+{
+    const Frame *frame = getCurrentFrame();
+    return frame != nullptr ? frame->cursorDeltaY : 0.f;
+}
+
+const bool vk::InputRecorder::isRawMode() const
+{
+    const Frame *frame = getCurrentFrame();
+    return frame != nullptr && (frame->flags & FLAG_RAW_MODE) != 0;
+}
+
+const vk::InputRecorder::Frame *vk::InputRecorder::getCurrentFrame() const
+{
+    if (currentFrame < 0 || currentFrame >= static_cast<int64_t>(frames.size()))
+        return nullptr;
+
+    return &frames[currentFrame];
+}
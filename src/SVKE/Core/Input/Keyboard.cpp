@@ -1,17 +1,41 @@
 #include "SVKE/Core/Input/Keyboard.hpp"
 
-vk::Keyboard::Keyboard(Window &window) : window(window)
+vk::Keyboard::Keyboard(Window &window) : window(window), recorder(nullptr)
 {
     // glfwSetInputMode(window.getHandle(), GLFW_STICKY_KEYS, GLFW_TRUE);
 }
 
 const bool vk::Keyboard::isKeyPressed(const Key &key)
 {
-    return glfwGetKey(window.getHandle(), static_cast<int>(key)) == GLFW_PRESS;
+    // A replay works headless too
+    if (recorder != nullptr && recorder->isReplaying())
+        return recorder->isKeyPressed(static_cast<int>(key));
+
+    // No keys exist without a window
+    if (window.isHeadless())
+        return false;
+
+    const bool pressed = glfwGetKey(window.getHandle(), static_cast<int>(key)) == GLFW_PRESS;
+
+    if (pressed && recorder != nullptr)
+        recorder->recordKey(static_cast<int>(key));
+
+    return pressed;
 }
 
 const bool vk::Keyboard::wasKeyReleased(const Key &key)
 {
+    if (recorder != nullptr && recorder->isReplaying())
+        return !recorder->isKeyPressed(static_cast<int>(key));
+
+    if (window.isHeadless())
+        return true;
+
     return glfwGetKey(window.getHandle(), static_cast<int>(key)) == GLFW_RELEASE;
 }
 
+void vk::Keyboard::setInputRecorder(InputRecorder *recorder)
+{
+    this->recorder = recorder;
+}
+
@@ -1,6 +1,6 @@
 #include "SVKE/Core/Input/Mouse.hpp"
 
-vk::Mouse::Mouse(Window &window) : window(window), rawModeEnabled(false)
+vk::Mouse::Mouse(Window &window) : window(window), rawModeEnabled(false), recorder(nullptr)
 {
     setCursorMode(CursorMode::Normal);
     resetCursorData();
@@ -16,13 +16,20 @@ void vk::Mouse::resetCursorData()
 
 void vk::Mouse::setCursorMode(const CursorMode &mode)
 {
-    glfwSetInputMode(window.getHandle(), GLFW_CURSOR, static_cast<int>(mode));
+    if (!window.isHeadless())
+        glfwSetInputMode(window.getHandle(), GLFW_CURSOR, static_cast<int>(mode));
     this->mode = mode;
     resetCursorData();
 }
 
 void vk::Mouse::setRawMode(const bool raw)
 {
+    if (window.isHeadless())
+    {
+        rawModeEnabled = raw;
+        return;
+    }
+
     if (raw)
         glfwSetInputMode(window.getHandle(), GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
     else
@@ -33,9 +40,26 @@ void vk::Mouse::setRawMode(const bool raw)
 
 void vk::Mouse::updateCursorData()
 {
+    // Only the deltas move the camera, the position is left as it is
+    if (recorder != nullptr && recorder->isReplaying())
+    {
+        data.deltaX = recorder->getCursorDeltaX();
+        data.deltaY = recorder->getCursorDeltaY();
+        return;
+    }
+
     double prev_x = data.x, prev_y = data.y;
 
-    glfwGetCursorPos(window.getHandle(), &data.x, &data.y);
+    // Headless, the cursor stays where it is and never moves
+    if (window.isHeadless())
+    {
+        data.x = 0.0;
+        data.y = 0.0;
+    }
+    else
+    {
+        glfwGetCursorPos(window.getHandle(), &data.x, &data.y);
+    }
 
     if (mode == CursorMode::Disabled)
     {
@@ -56,10 +80,22 @@ void vk::Mouse::updateCursorData()
         data.deltaX = 0.f;
         data.deltaY = 0.f;
     }
+
+    if (recorder != nullptr)
+        recorder->recordCursor(data.deltaX, data.deltaY, rawModeEnabled);
+}
+
+void vk::Mouse::setInputRecorder(InputRecorder *recorder)
+{
+    this->recorder = recorder;
 }
 
 const bool vk::Mouse::isRawModeEnabled() const
 {
+    // Raw deltas are not scaled by dt, the replay must treat them the way the recording did
+    if (recorder != nullptr && recorder->isReplaying())
+        return recorder->isRawMode();
+
     return rawModeEnabled;
 }
 
@@ -0,0 +1,422 @@
+#include "SVKE/Core/Math/TransformBatch.hpp"
+
+#include <cassert>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SVKE_TRANSFORM_BATCH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SVKE_TRANSFORM_BATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SVKE_TARGET_SSE  __attribute__((target("sse2")))
+#define SVKE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define SVKE_TARGET_SSE
+#define SVKE_TARGET_AVX2
+#endif
+
+namespace
+{
+// Writes one object's matrices from its (already evaluated) rotation sines and cosines.
+// Mat4f and Mat3f are column-major and tightly packed (16 and 9 floats).
+inline void storeMatrices(float *world, float *normal, const float tx, const float ty, const float tz, const float s1,
+                          const float c1, const float s2, const float c2, const float s3, const float c3,
+                          const float sx, const float sy, const float sz)
+{
+    const float ux = c1 * c3 + s1 * s2 * s3, uy = c2 * s3, uz = c1 * s2 * s3 - c3 * s1;
+    const float vx = c3 * s1 * s2 - c1 * s3, vy = c2 * c3, vz = c1 * c3 * s2 + s1 * s3;
+    const float wx = c2 * s1, wy = -s2, wz = c1 * c2;
+
+    world[0] = sx * ux, world[1] = sx * uy, world[2] = sx * uz, world[3] = 0.f;
+    world[4] = sy * vx, world[5] = sy * vy, world[6] = sy * vz, world[7] = 0.f;
+    world[8] = sz * wx, world[9] = sz * wy, world[10] = sz * wz, world[11] = 0.f;
+    world[12] = tx, world[13] = ty, world[14] = tz, world[15] = 1.f;
+
+    const float isx = 1.f / sx, isy = 1.f / sy, isz = 1.f / sz;
+    normal[0] = isx * ux, normal[1] = isx * uy, normal[2] = isx * uz;
+    normal[3] = isy * vx, normal[4] = isy * vy, normal[5] = isy * vz;
+    normal[6] = isz * wx, normal[7] = isz * wy, normal[8] = isz * wz;
+}
+
+// Same math as Object::TransformComponent, one object at a time
+void computeScalar(const vk::TransformBatch::Input &in, const size_t begin, vk::Mat4f *world_matrices,
+                   vk::Mat3f *normal_matrices)
+{
+    for (size_t i = begin; i < in.count; ++i)
+    {
+        storeMatrices(&world_matrices[i][0][0], &normal_matrices[i][0][0], in.translation[0][i], in.translation[1][i],
+                      in.translation[2][i], glm::sin(in.rotation[1][i]), glm::cos(in.rotation[1][i]),
+                      glm::sin(in.rotation[0][i]), glm::cos(in.rotation[0][i]), glm::sin(in.rotation[2][i]),
+                      glm::cos(in.rotation[2][i]), in.scale[0][i], in.scale[1][i], in.scale[2][i]);
+    }
+}
+
+#ifdef SVKE_TRANSFORM_BATCH_X86
+
+// Cephes single precision sin/cos constants (as used by sse_mathfun). Accurate to ~1e-7 for |x| < 8192.
+constexpr float FOUR_OVER_PI = 1.27323954473516f;
+constexpr float DP1 = -0.78515625f;
+constexpr float DP2 = -2.4187564849853515625e-4f;
+constexpr float DP3 = -3.77489497744594108e-8f;
+constexpr float SINCOF_P0 = -1.9515295891e-4f;
+constexpr float SINCOF_P1 = 8.3321608736e-3f;
+constexpr float SINCOF_P2 = -1.6666654611e-1f;
+constexpr float COSCOF_P0 = 2.443315711809948e-5f;
+constexpr float COSCOF_P1 = -1.388731625493765e-3f;
+constexpr float COSCOF_P2 = 4.166664568298827e-2f;
+
+// Transposes the per-lane results held in SoA scratch into the AoS matrix arrays
+template <int LANES>
+inline void scatterLanes(const float (&lanes)[25][LANES], const size_t base, vk::Mat4f *world_matrices,
+                         vk::Mat3f *normal_matrices)
+{
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        float *world = &world_matrices[base + lane][0][0];
+        float *normal = &normal_matrices[base + lane][0][0];
+
+        for (int e = 0; e < 16; ++e)
+            world[e] = lanes[e][lane];
+
+        for (int e = 0; e < 9; ++e)
+            normal[e] = lanes[16 + e][lane];
+    }
+}
+
+/* SSE (4 LANES) ---------------------------------------------------------------------------------------- */
+
+SVKE_TARGET_SSE inline void sincos4(__m128 x, __m128 &s, __m128 &c)
+{
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+
+    __m128 sign_bit_sin = _mm_and_ps(x, sign_mask);
+    x = _mm_andnot_ps(sign_mask, x);
+
+    // Octant selection: j = (int(x * 4/pi) + 1) & ~1
+    __m128 y = _mm_mul_ps(x, _mm_set1_ps(FOUR_OVER_PI));
+    __m128i j = _mm_cvttps_epi32(y);
+    j = _mm_add_epi32(j, _mm_set1_epi32(1));
+    j = _mm_and_si128(j, _mm_set1_epi32(~1));
+    y = _mm_cvtepi32_ps(j);
+
+    const __m128 swap_sign_sin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+    const __m128 sign_bit_cos = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    const __m128 poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    sign_bit_sin = _mm_xor_ps(sign_bit_sin, swap_sign_sin);
+
+    // Extended precision modular arithmetic: x = ((x - y * DP1) - y * DP2) - y * DP3
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP1)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP2)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP3)));
+
+    const __m128 z = _mm_mul_ps(x, x);
+
+    // Cosine polynomial on [0, pi/4]
+    __m128 yc = _mm_set1_ps(COSCOF_P0);
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COSCOF_P1));
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COSCOF_P2));
+    yc = _mm_mul_ps(_mm_mul_ps(yc, z), z);
+    yc = _mm_sub_ps(yc, _mm_mul_ps(z, _mm_set1_ps(.5f)));
+    yc = _mm_add_ps(yc, _mm_set1_ps(1.f));
+
+    // Sine polynomial on [0, pi/4]
+    __m128 ys = _mm_set1_ps(SINCOF_P0);
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SINCOF_P1));
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SINCOF_P2));
+    ys = _mm_mul_ps(_mm_mul_ps(ys, z), x);
+    ys = _mm_add_ps(ys, x);
+
+    const __m128 sin_value = _mm_or_ps(_mm_and_ps(poly_mask, ys), _mm_andnot_ps(poly_mask, yc));
+    const __m128 cos_value = _mm_or_ps(_mm_and_ps(poly_mask, yc), _mm_andnot_ps(poly_mask, ys));
+
+    s = _mm_xor_ps(sin_value, sign_bit_sin);
+    c = _mm_xor_ps(cos_value, sign_bit_cos);
+}
+
+SVKE_TARGET_SSE void computeSSE(const vk::TransformBatch::Input &in, const size_t begin, vk::Mat4f *world_matrices,
+                                vk::Mat3f *normal_matrices)
+{
+    alignas(16) float lanes[25][4];
+    const size_t end = begin + (in.count - begin) / 4 * 4;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+
+    for (size_t i = begin; i < end; i += 4)
+    {
+        __m128 s1, c1, s2, c2, s3, c3;
+        sincos4(_mm_loadu_ps(in.rotation[1] + i), s1, c1);
+        sincos4(_mm_loadu_ps(in.rotation[0] + i), s2, c2);
+        sincos4(_mm_loadu_ps(in.rotation[2] + i), s3, c3);
+
+        const __m128 s1s2 = _mm_mul_ps(s1, s2);
+        const __m128 c1s2 = _mm_mul_ps(c1, s2);
+
+        const __m128 ux = _mm_add_ps(_mm_mul_ps(c1, c3), _mm_mul_ps(s1s2, s3));
+        const __m128 uy = _mm_mul_ps(c2, s3);
+        const __m128 uz = _mm_sub_ps(_mm_mul_ps(c1s2, s3), _mm_mul_ps(c3, s1));
+        const __m128 vx = _mm_sub_ps(_mm_mul_ps(s1s2, c3), _mm_mul_ps(c1, s3));
+        const __m128 vy = _mm_mul_ps(c2, c3);
+        const __m128 vz = _mm_add_ps(_mm_mul_ps(c1s2, c3), _mm_mul_ps(s1, s3));
+        const __m128 wx = _mm_mul_ps(c2, s1);
+        const __m128 wy = _mm_sub_ps(zero, s2);
+        const __m128 wz = _mm_mul_ps(c1, c2);
+
+        const __m128 sx = _mm_loadu_ps(in.scale[0] + i);
+        const __m128 sy = _mm_loadu_ps(in.scale[1] + i);
+        const __m128 sz = _mm_loadu_ps(in.scale[2] + i);
+
+        _mm_store_ps(lanes[0], _mm_mul_ps(sx, ux));
+        _mm_store_ps(lanes[1], _mm_mul_ps(sx, uy));
+        _mm_store_ps(lanes[2], _mm_mul_ps(sx, uz));
+        _mm_store_ps(lanes[3], zero);
+        _mm_store_ps(lanes[4], _mm_mul_ps(sy, vx));
+        _mm_store_ps(lanes[5], _mm_mul_ps(sy, vy));
+        _mm_store_ps(lanes[6], _mm_mul_ps(sy, vz));
+        _mm_store_ps(lanes[7], zero);
+        _mm_store_ps(lanes[8], _mm_mul_ps(sz, wx));
+        _mm_store_ps(lanes[9], _mm_mul_ps(sz, wy));
+        _mm_store_ps(lanes[10], _mm_mul_ps(sz, wz));
+        _mm_store_ps(lanes[11], zero);
+        _mm_store_ps(lanes[12], _mm_loadu_ps(in.translation[0] + i));
+        _mm_store_ps(lanes[13], _mm_loadu_ps(in.translation[1] + i));
+        _mm_store_ps(lanes[14], _mm_loadu_ps(in.translation[2] + i));
+        _mm_store_ps(lanes[15], one);
+
+        const __m128 isx = _mm_div_ps(one, sx);
+        const __m128 isy = _mm_div_ps(one, sy);
+        const __m128 isz = _mm_div_ps(one, sz);
+
+        _mm_store_ps(lanes[16], _mm_mul_ps(isx, ux));
+        _mm_store_ps(lanes[17], _mm_mul_ps(isx, uy));
+        _mm_store_ps(lanes[18], _mm_mul_ps(isx, uz));
+        _mm_store_ps(lanes[19], _mm_mul_ps(isy, vx));
+        _mm_store_ps(lanes[20], _mm_mul_ps(isy, vy));
+        _mm_store_ps(lanes[21], _mm_mul_ps(isy, vz));
+        _mm_store_ps(lanes[22], _mm_mul_ps(isz, wx));
+        _mm_store_ps(lanes[23], _mm_mul_ps(isz, wy));
+        _mm_store_ps(lanes[24], _mm_mul_ps(isz, wz));
+
+        scatterLanes<4>(lanes, i, world_matrices, normal_matrices);
+    }
+
+    computeScalar(in, end, world_matrices, normal_matrices);
+}
+
+/* AVX2 (8 LANES) --------------------------------------------------------------------------------------- */
+
+SVKE_TARGET_AVX2 inline void sincos8(__m256 x, __m256 &s, __m256 &c)
+{
+    const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(0x80000000)));
+
+    __m256 sign_bit_sin = _mm256_and_ps(x, sign_mask);
+    x = _mm256_andnot_ps(sign_mask, x);
+
+    __m256 y = _mm256_mul_ps(x, _mm256_set1_ps(FOUR_OVER_PI));
+    __m256i j = _mm256_cvttps_epi32(y);
+    j = _mm256_add_epi32(j, _mm256_set1_epi32(1));
+    j = _mm256_and_si256(j, _mm256_set1_epi32(~1));
+    y = _mm256_cvtepi32_ps(j);
+
+    const __m256 swap_sign_sin =
+        _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    const __m256 sign_bit_cos = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    const __m256 poly_mask = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    sign_bit_sin = _mm256_xor_ps(sign_bit_sin, swap_sign_sin);
+
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(DP1), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(DP2), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(DP3), x);
+
+    const __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 yc = _mm256_set1_ps(COSCOF_P0);
+    yc = _mm256_fmadd_ps(yc, z, _mm256_set1_ps(COSCOF_P1));
+    yc = _mm256_fmadd_ps(yc, z, _mm256_set1_ps(COSCOF_P2));
+    yc = _mm256_mul_ps(_mm256_mul_ps(yc, z), z);
+    yc = _mm256_fnmadd_ps(z, _mm256_set1_ps(.5f), yc);
+    yc = _mm256_add_ps(yc, _mm256_set1_ps(1.f));
+
+    __m256 ys = _mm256_set1_ps(SINCOF_P0);
+    ys = _mm256_fmadd_ps(ys, z, _mm256_set1_ps(SINCOF_P1));
+    ys = _mm256_fmadd_ps(ys, z, _mm256_set1_ps(SINCOF_P2));
+    ys = _mm256_fmadd_ps(_mm256_mul_ps(ys, z), x, x);
+
+    const __m256 sin_value = _mm256_blendv_ps(yc, ys, poly_mask);
+    const __m256 cos_value = _mm256_blendv_ps(ys, yc, poly_mask);
+
+    s = _mm256_xor_ps(sin_value, sign_bit_sin);
+    c = _mm256_xor_ps(cos_value, sign_bit_cos);
+}
+
+SVKE_TARGET_AVX2 void computeAVX2(const vk::TransformBatch::Input &in, vk::Mat4f *world_matrices,
+                                  vk::Mat3f *normal_matrices)
+{
+    alignas(32) float lanes[25][8];
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+
+    for (size_t i = 0; i + 8 <= in.count; i += 8)
+    {
+        __m256 s1, c1, s2, c2, s3, c3;
+        sincos8(_mm256_loadu_ps(in.rotation[1] + i), s1, c1);
+        sincos8(_mm256_loadu_ps(in.rotation[0] + i), s2, c2);
+        sincos8(_mm256_loadu_ps(in.rotation[2] + i), s3, c3);
+
+        const __m256 s1s2 = _mm256_mul_ps(s1, s2);
+        const __m256 c1s2 = _mm256_mul_ps(c1, s2);
+
+        const __m256 ux = _mm256_fmadd_ps(s1s2, s3, _mm256_mul_ps(c1, c3));
+        const __m256 uy = _mm256_mul_ps(c2, s3);
+        const __m256 uz = _mm256_fmsub_ps(c1s2, s3, _mm256_mul_ps(c3, s1));
+        const __m256 vx = _mm256_fmsub_ps(s1s2, c3, _mm256_mul_ps(c1, s3));
+        const __m256 vy = _mm256_mul_ps(c2, c3);
+        const __m256 vz = _mm256_fmadd_ps(c1s2, c3, _mm256_mul_ps(s1, s3));
+        const __m256 wx = _mm256_mul_ps(c2, s1);
+        const __m256 wy = _mm256_sub_ps(zero, s2);
+        const __m256 wz = _mm256_mul_ps(c1, c2);
+
+        const __m256 sx = _mm256_loadu_ps(in.scale[0] + i);
+        const __m256 sy = _mm256_loadu_ps(in.scale[1] + i);
+        const __m256 sz = _mm256_loadu_ps(in.scale[2] + i);
+
+        _mm256_store_ps(lanes[0], _mm256_mul_ps(sx, ux));
+        _mm256_store_ps(lanes[1], _mm256_mul_ps(sx, uy));
+        _mm256_store_ps(lanes[2], _mm256_mul_ps(sx, uz));
+        _mm256_store_ps(lanes[3], zero);
+        _mm256_store_ps(lanes[4], _mm256_mul_ps(sy, vx));
+        _mm256_store_ps(lanes[5], _mm256_mul_ps(sy, vy));
+        _mm256_store_ps(lanes[6], _mm256_mul_ps(sy, vz));
+        _mm256_store_ps(lanes[7], zero);
+        _mm256_store_ps(lanes[8], _mm256_mul_ps(sz, wx));
+        _mm256_store_ps(lanes[9], _mm256_mul_ps(sz, wy));
+        _mm256_store_ps(lanes[10], _mm256_mul_ps(sz, wz));
+        _mm256_store_ps(lanes[11], zero);
+        _mm256_store_ps(lanes[12], _mm256_loadu_ps(in.translation[0] + i));
+        _mm256_store_ps(lanes[13], _mm256_loadu_ps(in.translation[1] + i));
+        _mm256_store_ps(lanes[14], _mm256_loadu_ps(in.translation[2] + i));
+        _mm256_store_ps(lanes[15], one);
+
+        const __m256 isx = _mm256_div_ps(one, sx);
+        const __m256 isy = _mm256_div_ps(one, sy);
+        const __m256 isz = _mm256_div_ps(one, sz);
+
+        _mm256_store_ps(lanes[16], _mm256_mul_ps(isx, ux));
+        _mm256_store_ps(lanes[17], _mm256_mul_ps(isx, uy));
+        _mm256_store_ps(lanes[18], _mm256_mul_ps(isx, uz));
+        _mm256_store_ps(lanes[19], _mm256_mul_ps(isy, vx));
+        _mm256_store_ps(lanes[20], _mm256_mul_ps(isy, vy));
+        _mm256_store_ps(lanes[21], _mm256_mul_ps(isy, vz));
+        _mm256_store_ps(lanes[22], _mm256_mul_ps(isz, wx));
+        _mm256_store_ps(lanes[23], _mm256_mul_ps(isz, wy));
+        _mm256_store_ps(lanes[24], _mm256_mul_ps(isz, wz));
+
+        scatterLanes<8>(lanes, i, world_matrices, normal_matrices);
+    }
+
+    // Remaining objects go through the 4-wide and scalar paths
+    computeSSE(in, in.count / 8 * 8, world_matrices, normal_matrices);
+}
+
+#endif
+
+vk::TransformBatch::Path detectPreferredPath()
+{
+#ifdef SVKE_TRANSFORM_BATCH_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+    bool avx2 = false;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2 && fma && os_avx)
+        return vk::TransformBatch::Path::AVX2;
+
+    if (sse2)
+        return vk::TransformBatch::Path::SSE;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return vk::TransformBatch::Path::AVX2;
+
+    if (__builtin_cpu_supports("sse2"))
+        return vk::TransformBatch::Path::SSE;
+#endif
+#endif
+
+    return vk::TransformBatch::Path::Scalar;
+}
+} // namespace
+
+void vk::TransformBatch::compute(const Input &input, Mat4f *world_matrices, Mat3f *normal_matrices)
+{
+    compute(input, world_matrices, normal_matrices, getPreferredPath());
+}
+
+void vk::TransformBatch::compute(const Input &input, Mat4f *world_matrices, Mat3f *normal_matrices, const Path &path)
+{
+    assert(isPathSupported(path) && "TRANSFORM BATCH PATH IS NOT SUPPORTED BY THIS CPU");
+
+    switch (path)
+    {
+#ifdef SVKE_TRANSFORM_BATCH_X86
+    case Path::AVX2:
+        computeAVX2(input, world_matrices, normal_matrices);
+        break;
+    case Path::SSE:
+        computeSSE(input, 0, world_matrices, normal_matrices);
+        break;
+#endif
+    default:
+        computeScalar(input, 0, world_matrices, normal_matrices);
+        break;
+    }
+}
+
+const bool vk::TransformBatch::isPathSupported(const Path &path)
+{
+    return static_cast<int>(path) <= static_cast<int>(getPreferredPath());
+}
+
+const vk::TransformBatch::Path &vk::TransformBatch::getPreferredPath()
+{
+    static const Path preferred = detectPreferredPath();
+
+    return preferred;
+}
+
+const char *vk::TransformBatch::getPathName(const Path &path)
+{
+    switch (path)
+    {
+    case Path::Scalar:
+        return "Scalar";
+    case Path::SSE:
+        return "SSE";
+    case Path::AVX2:
+        return "AVX2";
+    default:
+        return "Unknown";
+    }
+}
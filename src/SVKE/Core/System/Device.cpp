@@ -1,6 +1,10 @@
 #include "SVKE/Core/System/Device.hpp"
 
-vk::Device::Device(Window &window, const MSAA &preferred_msaa_samples) : window(window)
+#include <filesystem>
+#include <fstream>
+
+vk::Device::Device(Window &window, const MSAA &preferred_msaa_samples, const std::string &pipeline_cache_path)
+    : window(window), pipelineCachePath(pipeline_cache_path)
 {
     nullifyHandles();
     createInstance();
@@ -10,10 +14,14 @@ vk::Device::Device(Window &window, const MSAA &preferred_msaa_samples) : window(
     createLogicalDevice();
     createVmaAllocator();
     createCommandPool();
+    createPipelineCache();
 }
 
 vk::Device::~Device()
 {
+    savePipelineCache();
+
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
     vkDestroyCommandPool(device, commandPool, nullptr);
     vmaDestroyAllocator(allocator);
     vkDestroyDevice(device, nullptr);
@@ -22,7 +30,9 @@ vk::Device::~Device()
     destroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 #endif
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    if (surface != VK_NULL_HANDLE)
+        vkDestroySurfaceKHR(instance, surface, nullptr);
+
     vkDestroyInstance(instance, nullptr);
 }
 
@@ -51,6 +61,49 @@ VkCommandPool vk::Device::getCommandPool()
     return commandPool;
 }
 
+VkPipelineCache vk::Device::getPipelineCache()
+{
+    return pipelineCache;
+}
+
+const bool vk::Device::savePipelineCache()
+{
+    if (pipelineCachePath.empty() || pipelineCache == VK_NULL_HANDLE)
+        return false;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return false;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+        return false;
+
+    const std::string temporary_path = pipelineCachePath + ".tmp";
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open() || !file.write(data.data(), static_cast<std::streamsize>(size)))
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, pipelineCachePath, error);
+
+    if (error)
+    {
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+
+#ifndef NDEBUG
+    std::cout << "SAVED PIPELINE CACHE " << pipelineCachePath << " (" << size << " bytes)" << std::endl;
+#endif
+
+    return true;
+}
+
 VkQueue vk::Device::getGraphicsQueue()
 {
     return graphicsQueue;
@@ -71,6 +124,31 @@ const VkSampleCountFlagBits &vk::Device::getCurrentMsaaSamples() const
     return currentMsaaSamples;
 }
 
+const bool vk::Device::supportsDynamicRendering() const
+{
+    return dynamicRenderingSupported;
+}
+
+const bool vk::Device::isHeadless() const
+{
+    return window.isHeadless();
+}
+
+const bool vk::Device::supportsPresentWait() const
+{
+    return presentWaitSupported;
+}
+
+const bool vk::Device::supportsPipelineStatistics() const
+{
+    return pipelineStatisticsSupported;
+}
+
+const uint32_t vk::Device::getGraphicsTimestampValidBits() const
+{
+    return graphicsTimestampValidBits;
+}
+
 VkSampleCountFlagBits vk::Device::getMsaaSamplesOrClosest(const MSAA &samples) const
 {
     VkSampleCountFlags counts =
@@ -99,6 +177,8 @@ VkSampleCountFlagBits vk::Device::getMsaaSamplesOrClosest(const MSAA &samples) c
 
 vk::Device::SwapchainSupportDetails vk::Device::getSwapchainSupport()
 {
+    assert(!window.isHeadless() && "A HEADLESS DEVICE HAS NO SWAPCHAIN SUPPORT");
+
     return querySwapchainSupport(physicalDevice);
 }
 
@@ -178,6 +258,126 @@ void vk::Device::createImageWithInfo(const VkImageCreateInfo &image_info, VkMemo
 
     if (result != VK_SUCCESS)
         throw std::runtime_error("vk::Device::createImageWithInfo: FAILED TO CREATE IMAGE WITH VMA");
+
+    trackAllocation(image_memory, MemoryStats::categorizeImage(image_info.usage));
+}
+
+void vk::Device::destroyImage(VkImage image, VmaAllocation allocation)
+{
+    untrackAllocation(allocation);
+    vmaDestroyImage(allocator, image, allocation);
+}
+
+void vk::Device::trackAllocation(VmaAllocation allocation, const MemoryCategory &category)
+{
+    const size_t index = static_cast<size_t>(category);
+
+    VmaAllocationInfo info = {};
+    vmaGetAllocationInfo(allocator, allocation, &info);
+
+    // The category is kept in the user data, offset by one so untracked allocations read as null
+    vmaSetAllocationUserData(allocator, allocation, reinterpret_cast<void *>(index + 1));
+    vmaSetAllocationName(allocator, allocation, MemoryStats::getCategoryName(category));
+
+    ++categoryAllocationCounts[index];
+    categoryBytes[index] += info.size;
+}
+
+void vk::Device::untrackAllocation(VmaAllocation allocation)
+{
+    if (allocation == VK_NULL_HANDLE)
+        return;
+
+    VmaAllocationInfo info = {};
+    vmaGetAllocationInfo(allocator, allocation, &info);
+
+    const uintptr_t tag = reinterpret_cast<uintptr_t>(info.pUserData);
+    if (tag == 0 || tag > MemoryStats::CATEGORY_COUNT)
+        return;
+
+    --categoryAllocationCounts[tag - 1];
+    categoryBytes[tag - 1] -= info.size;
+}
+
+const vk::MemoryStats vk::Device::getMemoryStats() const
+{
+    MemoryStats stats;
+
+    const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+    vmaGetMemoryProperties(allocator, &memory_properties);
+
+    VmaTotalStatistics total = {};
+    vmaCalculateStatistics(allocator, &total);
+
+    std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i)
+    {
+        MemoryStats::Heap heap;
+        heap.deviceLocal = memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+        heap.size = memory_properties->memoryHeaps[i].size;
+        heap.usage = budgets[i].usage;
+        heap.budget = budgets[i].budget;
+        heap.blockCount = total.memoryHeap[i].statistics.blockCount;
+        heap.allocationCount = total.memoryHeap[i].statistics.allocationCount;
+        heap.blockBytes = total.memoryHeap[i].statistics.blockBytes;
+        heap.allocationBytes = total.memoryHeap[i].statistics.allocationBytes;
+
+        stats.heaps.push_back(heap);
+    }
+
+    for (uint32_t i = 0; i < memory_properties->memoryTypeCount; ++i)
+    {
+        const VmaDetailedStatistics &type = total.memoryType[i];
+        if (type.statistics.blockCount == 0)
+            continue;
+
+        MemoryStats::Pool pool;
+        pool.memoryTypeIndex = i;
+        pool.heapIndex = memory_properties->memoryTypes[i].heapIndex;
+        pool.propertyFlags = memory_properties->memoryTypes[i].propertyFlags;
+        pool.blockCount = type.statistics.blockCount;
+        pool.allocationCount = type.statistics.allocationCount;
+        pool.blockBytes = type.statistics.blockBytes;
+        pool.allocationBytes = type.statistics.allocationBytes;
+        pool.unusedRangeCount = type.unusedRangeCount;
+        pool.largestUnusedRange = type.unusedRangeCount > 0 ? type.unusedRangeSizeMax : 0;
+
+        // Share of the free space outside the largest free range
+        const VkDeviceSize free_bytes = pool.blockBytes - pool.allocationBytes;
+        if (free_bytes > 0)
+            pool.fragmentation = 1.f - static_cast<float>(static_cast<double>(pool.largestUnusedRange) /
+                                                          static_cast<double>(free_bytes));
+
+        stats.pools.push_back(pool);
+    }
+
+    for (size_t i = 0; i < MemoryStats::CATEGORY_COUNT; ++i)
+    {
+        stats.categories[i].allocationCount = categoryAllocationCounts[i];
+        stats.categories[i].bytes = categoryBytes[i];
+    }
+
+    stats.totalAllocationCount = total.total.statistics.allocationCount;
+    stats.totalAllocationBytes = total.total.statistics.allocationBytes;
+    stats.totalBlockBytes = total.total.statistics.blockBytes;
+
+    return stats;
+}
+
+const bool vk::Device::writeMemoryJson(const std::string &path) const
+{
+    char *json = nullptr;
+    vmaBuildStatsString(allocator, &json, VK_TRUE);
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (file.is_open())
+        file << json;
+
+    vmaFreeStatsString(allocator, json);
+
+    return file.is_open() && file.good();
 }
 
 const std::string vk::Device::getMsaaSamplesAsString(const MSAA &samples)
@@ -214,6 +414,18 @@ void vk::Device::nullifyHandles()
     presentQueue = VK_NULL_HANDLE;
     allocator = VK_NULL_HANDLE;
     commandPool = VK_NULL_HANDLE;
+    pipelineCache = VK_NULL_HANDLE;
+
+    dynamicRenderingSupported = false;
+    presentWaitSupported = false;
+    pipelineStatisticsSupported = false;
+    graphicsTimestampValidBits = 0;
+
+    for (size_t i = 0; i < MemoryStats::CATEGORY_COUNT; ++i)
+    {
+        categoryAllocationCounts[i] = 0;
+        categoryBytes[i] = 0;
+    }
 }
 
 void vk::Device::createInstance()
@@ -272,6 +484,9 @@ void vk::Device::setupDebugMessenger()
 
 void vk::Device::createSurface()
 {
+    if (window.isHeadless())
+        return;
+
     window.createSurface(instance, surface);
 }
 
@@ -301,6 +516,21 @@ void vk::Device::pickAdequatePhysicalDevice(const MSAA &preferred_msaa_samples)
 
         vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 
+        dynamicRenderingSupported = queryDynamicRenderingSupport(physicalDevice);
+        presentWaitSupported = !window.isHeadless() && queryPresentWaitSupport(physicalDevice);
+
+        VkPhysicalDeviceFeatures features;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+        pipelineStatisticsSupported = features.pipelineStatisticsQuery == VK_TRUE;
+
+        uint32_t queue_family_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queue_family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queue_family_count, queue_families.data());
+
+        graphicsTimestampValidBits =
+            queue_families[*findQueueFamilies(physicalDevice).graphicsFamily].timestampValidBits;
+
         currentMsaaSamples = getMsaaSamplesOrClosest(preferred_msaa_samples);
 
 #ifndef NDEBUG
@@ -339,6 +569,7 @@ void vk::Device::createLogicalDevice()
     VkPhysicalDeviceFeatures device_features = {};
     device_features.samplerAnisotropy = VK_TRUE;
     device_features.sampleRateShading = VK_TRUE;
+    device_features.pipelineStatisticsQuery = pipelineStatisticsSupported ? VK_TRUE : VK_FALSE;
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -347,8 +578,41 @@ void vk::Device::createLogicalDevice()
     createInfo.pQueueCreateInfos = queue_create_infos.data();
 
     createInfo.pEnabledFeatures = &device_features;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
-    createInfo.ppEnabledExtensionNames = DEVICE_EXTENSIONS.data();
+
+    /* OPTIONAL FEATURES ------------------------------------------------------------------------------------ */
+
+    // Each supported feature struct is pushed to the front of the pNext chain
+    std::vector<const char *> extensions = getDeviceExtensions();
+
+    VkPhysicalDeviceVulkan13Features vulkan13_features = {};
+    vulkan13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    vulkan13_features.dynamicRendering = VK_TRUE;
+
+    if (dynamicRenderingSupported)
+    {
+        vulkan13_features.pNext = const_cast<void *>(createInfo.pNext);
+        createInfo.pNext = &vulkan13_features;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {};
+    present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.presentId = VK_TRUE;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {};
+    present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    present_wait_features.presentWait = VK_TRUE;
+
+    if (presentWaitSupported)
+    {
+        extensions.insert(extensions.end(), PRESENT_WAIT_EXTENSIONS.begin(), PRESENT_WAIT_EXTENSIONS.end());
+
+        present_wait_features.pNext = const_cast<void *>(createInfo.pNext);
+        present_id_features.pNext = &present_wait_features;
+        createInfo.pNext = &present_id_features;
+    }
+
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
     // might not really be necessary anymore because device specific validation layers
     // have been deprecated
@@ -398,6 +662,58 @@ void vk::Device::createCommandPool()
         throw std::runtime_error("vk::Device::createCommandPool FAILED TO CREATE COMMAND POOL");
 }
 
+void vk::Device::createPipelineCache()
+{
+    std::vector<char> data;
+
+    if (!pipelineCachePath.empty())
+    {
+        std::ifstream file(pipelineCachePath, std::ios::ate | std::ios::binary);
+
+        if (file.is_open())
+        {
+            data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if (!file || !isPipelineCacheCompatible(data))
+            {
+#ifndef NDEBUG
+                std::cout << "DISCARDED INCOMPATIBLE PIPELINE CACHE " << pipelineCachePath << std::endl;
+#endif
+                data.clear();
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cache_info = {};
+    cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cache_info.initialDataSize = data.size();
+    cache_info.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &cache_info, nullptr, &pipelineCache) != VK_SUCCESS)
+        throw std::runtime_error("vk::Device::createPipelineCache: FAILED TO CREATE PIPELINE CACHE");
+
+#ifndef NDEBUG
+    if (!data.empty())
+        std::cout << "LOADED PIPELINE CACHE " << pipelineCachePath << " (" << data.size() << " bytes)" << std::endl;
+#endif
+}
+
+const bool vk::Device::isPipelineCacheCompatible(const std::vector<char> &data) const
+{
+    VkPipelineCacheHeaderVersionOne header = {};
+
+    if (data.size() < sizeof(header))
+        return false;
+
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 const int vk::Device::rateDeviceSuitability(VkPhysicalDevice physical_device)
 {
     int score = 0;
@@ -432,7 +748,7 @@ const int vk::Device::rateDeviceSuitability(VkPhysicalDevice physical_device)
         score = -1;
 
     // Require that swap chain is adequate
-    if (extension_support)
+    if (extension_support && !window.isHeadless())
     {
         SwapchainSupportDetails details = querySwapchainSupport(physical_device);
         if (details.formats.empty() || details.presentModes.empty())
@@ -448,12 +764,18 @@ const int vk::Device::rateDeviceSuitability(VkPhysicalDevice physical_device)
 
 const std::vector<const char *> vk::Device::getRequiredExtensions()
 {
-    uint32_t glfw_extension_count = 0;
-    const char **glfw_extensions;
+    std::vector<const char *> extensions;
 
-    glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+    // Surface extensions are only needed to present
+    if (!window.isHeadless())
+    {
+        uint32_t glfw_extension_count = 0;
+        const char **glfw_extensions;
+
+        glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
 
-    std::vector<const char *> extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+        extensions.assign(glfw_extensions, glfw_extensions + glfw_extension_count);
+    }
 
 #ifndef NDEBUG
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -560,6 +882,16 @@ void vk::Device::checkGflwRequiredInstanceExtensions()
 #endif
 }
 
+const std::vector<const char *> vk::Device::getDeviceExtensions() const
+{
+    std::vector<const char *> extensions = DEVICE_EXTENSIONS;
+
+    if (!window.isHeadless())
+        extensions.insert(extensions.end(), SWAPCHAIN_EXTENSIONS.begin(), SWAPCHAIN_EXTENSIONS.end());
+
+    return extensions;
+}
+
 const bool vk::Device::checkDeviceExtensionSupport(VkPhysicalDevice physical_device)
 {
     uint32_t extension_count = 0;
@@ -568,7 +900,8 @@ const bool vk::Device::checkDeviceExtensionSupport(VkPhysicalDevice physical_dev
     std::vector<VkExtensionProperties> available_extensions(extension_count);
     vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
 
-    std::set<std::string> required_extensions(DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end());
+    const std::vector<const char *> device_extensions = getDeviceExtensions();
+    std::set<std::string> required_extensions(device_extensions.begin(), device_extensions.end());
 
     for (const auto &extension : available_extensions)
         required_extensions.erase(extension.extensionName);
@@ -605,6 +938,59 @@ VkSampleCountFlagBits vk::Device::queryMaxUsableSampleCount(VkPhysicalDevice phy
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
+const bool vk::Device::queryDynamicRenderingSupport(VkPhysicalDevice physical_device)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+    // Core since 1.3, older devices would need VK_KHR_dynamic_rendering
+    if (properties.apiVersion < VK_API_VERSION_1_3)
+        return false;
+
+    VkPhysicalDeviceVulkan13Features vulkan13_features = {};
+    vulkan13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan13_features;
+
+    vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+    return vulkan13_features.dynamicRendering == VK_TRUE;
+}
+
+const bool vk::Device::queryPresentWaitSupport(VkPhysicalDevice physical_device)
+{
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
+
+    std::set<std::string> missing_extensions(PRESENT_WAIT_EXTENSIONS.begin(), PRESENT_WAIT_EXTENSIONS.end());
+
+    for (const auto &extension : available_extensions)
+        missing_extensions.erase(extension.extensionName);
+
+    if (!missing_extensions.empty())
+        return false;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features = {};
+    present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features = {};
+    present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.pNext = &present_wait_features;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &present_id_features;
+
+    vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+    return present_id_features.presentId == VK_TRUE && present_wait_features.presentWait == VK_TRUE;
+}
+
 vk::Device::QueueFamilyIndices vk::Device::findQueueFamilies(VkPhysicalDevice physical_device)
 {
     QueueFamilyIndices indices;
@@ -621,8 +1007,12 @@ vk::Device::QueueFamilyIndices vk::Device::findQueueFamilies(VkPhysicalDevice ph
         if (queue_family.queueCount > 0 && queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
             indices.graphicsFamily = i;
 
+        // Headless, nothing is presented and the graphics queue stands in for the present queue
         VkBool32 present_support = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &present_support);
+        if (window.isHeadless())
+            present_support = queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT ? VK_TRUE : VK_FALSE;
+        else
+            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, surface, &present_support);
 
         if (queue_family.queueCount > 0 && present_support)
             indices.presentFamily = i;
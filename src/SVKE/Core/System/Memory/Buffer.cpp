@@ -1,7 +1,7 @@
 #include "SVKE/Core/System/Memory/Buffer.hpp"
 
 vk::Buffer::Buffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage)
-    : device(device), buffer(VK_NULL_HANDLE), allocation(VK_NULL_HANDLE), size(0), mappedMem(nullptr)
+    : device(device), buffer(VK_NULL_HANDLE), allocation(VK_NULL_HANDLE), size(size), mappedMem(nullptr)
 {
     VkBufferCreateInfo buffer_info = {};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -13,11 +13,13 @@ vk::Buffer::Buffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage,
 
     if (vmaCreateBuffer(device.getAllocator(), &buffer_info, &alloc_info, &buffer, &allocation, nullptr) != VK_SUCCESS)
         throw std::runtime_error("vk::Buffer::Buffer: FAILED TO CREATE BUFFER");
+
+    device.trackAllocation(allocation, MemoryStats::categorizeBuffer(usage));
 }
 
 vk::Buffer::Buffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage,
                    VmaAllocationCreateFlags flags)
-    : device(device), buffer(VK_NULL_HANDLE), allocation(VK_NULL_HANDLE), size(0), mappedMem(nullptr)
+    : device(device), buffer(VK_NULL_HANDLE), allocation(VK_NULL_HANDLE), size(size), mappedMem(nullptr)
 {
     VkBufferCreateInfo buffer_info = {};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -31,6 +33,8 @@ vk::Buffer::Buffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage,
 
     if (vmaCreateBuffer(device.getAllocator(), &buffer_info, &alloc_info, &buffer, &allocation, nullptr) != VK_SUCCESS)
         throw std::runtime_error("vk::Buffer::Buffer: FAILED TO CREATE BUFFER");
+
+    device.trackAllocation(allocation, MemoryStats::categorizeBuffer(usage));
 }
 
 vk::Buffer::~Buffer()
@@ -40,6 +44,7 @@ vk::Buffer::~Buffer()
     if (mappedMem != nullptr)
         unmap();
 
+    device.untrackAllocation(allocation);
     vmaDestroyBuffer(device.getAllocator(), buffer, allocation);
 }
 
@@ -59,11 +64,36 @@ void vk::Buffer::unmap()
     mappedMem = nullptr; // Reset pointer
 }
 
-void vk::Buffer::write(void *data, VkDeviceSize size)
+void vk::Buffer::write(const void *data, VkDeviceSize size, VkDeviceSize offset)
 {
     assert(mappedMem != nullptr && "CANNOT WRITE TO NOT MAPPED BUFFER");
+    assert(offset + size <= this->size && "WRITE IS OUT OF BUFFER BOUNDS");
+
+    memcpy(static_cast<char *>(mappedMem) + offset, data, size);
+}
+
+void vk::Buffer::flush(VkDeviceSize size, VkDeviceSize offset)
+{
+    assert((size == VK_WHOLE_SIZE || offset + size <= this->size) && "FLUSH IS OUT OF BUFFER BOUNDS");
+
+    if (vmaFlushAllocation(device.getAllocator(), allocation, offset, size) != VK_SUCCESS)
+        throw std::runtime_error("vk::Buffer::flush: FAILED TO FLUSH BUFFER");
+}
+
+void vk::Buffer::read(void *data, VkDeviceSize size, VkDeviceSize offset) const
+{
+    assert(mappedMem != nullptr && "CANNOT READ FROM NOT MAPPED BUFFER");
+    assert(offset + size <= this->size && "READ IS OUT OF BUFFER BOUNDS");
+
+    memcpy(data, static_cast<const char *>(mappedMem) + offset, size);
+}
+
+void vk::Buffer::invalidate(VkDeviceSize size, VkDeviceSize offset)
+{
+    assert((size == VK_WHOLE_SIZE || offset + size <= this->size) && "INVALIDATE IS OUT OF BUFFER BOUNDS");
 
-    memcpy(mappedMem, data, size);
+    if (vmaInvalidateAllocation(device.getAllocator(), allocation, offset, size) != VK_SUCCESS)
+        throw std::runtime_error("vk::Buffer::invalidate: FAILED TO INVALIDATE BUFFER");
 }
 
 void vk::Buffer::copyTo(Buffer &other, const VkDeviceSize &size)
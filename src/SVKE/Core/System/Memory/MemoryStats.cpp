@@ -0,0 +1,47 @@
+#include "SVKE/Core/System/Memory/MemoryStats.hpp"
+
+const char *vk::MemoryStats::getCategoryName(const MemoryCategory category)
+{
+    switch (category)
+    {
+    case MemoryCategory::Geometry:
+        return "Geometry";
+    case MemoryCategory::Textures:
+        return "Textures";
+    case MemoryCategory::Attachments:
+        return "Attachments";
+    case MemoryCategory::Uniforms:
+        return "Uniforms";
+    case MemoryCategory::Staging:
+        return "Staging";
+    default:
+        return "Other";
+    }
+}
+
+const vk::MemoryCategory vk::MemoryStats::categorizeBuffer(const VkBufferUsageFlags usage)
+{
+    if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                 VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT))
+        return MemoryCategory::Geometry;
+
+    if (usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+        return MemoryCategory::Uniforms;
+
+    if (usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+        return MemoryCategory::Staging;
+
+    return MemoryCategory::Other;
+}
+
+const vk::MemoryCategory vk::MemoryStats::categorizeImage(const VkImageUsageFlags usage)
+{
+    if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                 VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+        return MemoryCategory::Attachments;
+
+    if (usage & VK_IMAGE_USAGE_SAMPLED_BIT)
+        return MemoryCategory::Textures;
+
+    return MemoryCategory::Other;
+}
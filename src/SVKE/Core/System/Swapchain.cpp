@@ -1,16 +1,23 @@
 #include "SVKE/Core/System/Swapchain.hpp"
 
-vk::Swapchain::Swapchain(Device &device, Window &window, const PresentMode &preferred_present_mode)
-    : device(device), window(window), currentFrame(0)
+vk::Swapchain::Swapchain(Device &device, Window &window, const PresentMode &preferred_present_mode,
+                         const RenderPath &render_path, const RenderingMode &rendering_mode,
+                         const uint32_t frames_in_flight, const uint32_t preferred_image_count,
+                         const bool internal_target)
+    : device(device), window(window), renderPath(render_path), renderingMode(rendering_mode),
+      internalTarget(internal_target), framesInFlight(frames_in_flight), currentFrame(0)
 {
-    init(preferred_present_mode);
+    init(preferred_present_mode, preferred_image_count);
 }
 
 vk::Swapchain::Swapchain(Device &device, Window &window, std::shared_ptr<Swapchain> &previous,
-                         const PresentMode &preferred_present_mode)
-    : device(device), window(window), oldSwapchain(previous), currentFrame(0)
+                         const PresentMode &preferred_present_mode, const RenderPath &render_path,
+                         const RenderingMode &rendering_mode, const uint32_t frames_in_flight,
+                         const uint32_t preferred_image_count, const bool internal_target)
+    : device(device), window(window), renderPath(render_path), renderingMode(rendering_mode),
+      internalTarget(internal_target), oldSwapchain(previous), framesInFlight(frames_in_flight), currentFrame(0)
 {
-    init(preferred_present_mode);
+    init(preferred_present_mode, preferred_image_count);
 
     // Give up ownership
     oldSwapchain = nullptr;
@@ -31,29 +38,52 @@ vk::Swapchain::~Swapchain()
         swapchain = nullptr;
     }
 
+    for (int i = 0; i < imageAllocations.size(); i++)
+        device.destroyImage(images[i], imageAllocations[i]);
+
     for (int i = 0; i < depthImages.size(); i++)
     {
         vkDestroyImageView(device.getLogicalDevice(), depthImageViews[i], nullptr);
-        vmaDestroyImage(device.getAllocator(), depthImages[i], depthImageAllocations[i]);
+        device.destroyImage(depthImages[i], depthImageAllocations[i]);
+    }
+
+    for (int i = 0; i < internalImages.size(); i++)
+    {
+        vkDestroyImageView(device.getLogicalDevice(), internalImageViews[i], nullptr);
+        device.destroyImage(internalImages[i], internalImageAllocations[i]);
+    }
+
+    if (colorImage != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(device.getLogicalDevice(), colorImageView, nullptr);
+        device.destroyImage(colorImage, colorImageAllocation);
     }
 
-    vkDestroyImageView(device.getLogicalDevice(), colorImageView, nullptr);
-    vmaDestroyImage(device.getAllocator(), colorImage, colorImageAllocation);
+    if (albedoImage != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(device.getLogicalDevice(), albedoImageView, nullptr);
+        device.destroyImage(albedoImage, albedoImageAllocation);
+        vkDestroyImageView(device.getLogicalDevice(), normalImageView, nullptr);
+        device.destroyImage(normalImage, normalImageAllocation);
+    }
 
     for (auto framebuffer : framebuffers)
     {
         vkDestroyFramebuffer(device.getLogicalDevice(), framebuffer, nullptr);
     }
 
-    vkDestroyRenderPass(device.getLogicalDevice(), renderPass, nullptr);
+    if (renderPass != VK_NULL_HANDLE)
+        vkDestroyRenderPass(device.getLogicalDevice(), renderPass, nullptr);
 
     // cleanup synchronization objects
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (size_t i = 0; i < framesInFlight; i++)
     {
-        vkDestroySemaphore(device.getLogicalDevice(), renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(device.getLogicalDevice(), imageAvailableSemaphores[i], nullptr);
         vkDestroyFence(device.getLogicalDevice(), inFlightFences[i], nullptr);
     }
+
+    for (auto semaphore : renderFinishedSemaphores)
+        vkDestroySemaphore(device.getLogicalDevice(), semaphore, nullptr);
 }
 
 VkResult vk::Swapchain::submitCommandBuffers(const VkCommandBuffer &buffers, uint32_t &image_index)
@@ -64,6 +94,23 @@ VkResult vk::Swapchain::submitCommandBuffers(const VkCommandBuffer &buffers, uin
     }
     imagesInFlight[image_index] = inFlightFences[currentFrame];
 
+    if (device.isHeadless())
+    {
+        // Nothing was acquired and nothing will be presented, so there is nothing to wait on or signal
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &buffers;
+
+        vkResetFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame]);
+        if (vkQueueSubmit(device.getGraphicsQueue(), 1, &submit_info, inFlightFences[currentFrame]) != VK_SUCCESS)
+            throw std::runtime_error("vk::Swapchain::submitCommandBuffers: FAILED TO SUBMIT COMMAND BUFFER");
+
+        currentFrame = (currentFrame + 1) % framesInFlight;
+
+        return VK_SUCCESS;
+    }
+
     VkSubmitInfo submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -76,7 +123,7 @@ VkResult vk::Swapchain::submitCommandBuffers(const VkCommandBuffer &buffers, uin
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &buffers;
 
-    VkSemaphore signal_semaphores[] = {renderFinishedSemaphores[currentFrame]};
+    VkSemaphore signal_semaphores[] = {renderFinishedSemaphores[image_index]};
     submit_info.signalSemaphoreCount = 1;
     submit_info.pSignalSemaphores = signal_semaphores;
 
@@ -96,9 +143,23 @@ VkResult vk::Swapchain::submitCommandBuffers(const VkCommandBuffer &buffers, uin
 
     present_info.pImageIndices = &image_index;
 
+    // Tags the present so waitForLastPresent() can wait for it
+    const uint64_t present_id = presentId + 1;
+
+    VkPresentIdKHR present_id_info = {};
+    present_id_info.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    present_id_info.swapchainCount = 1;
+    present_id_info.pPresentIds = &present_id;
+
+    if (waitForPresent != nullptr)
+        present_info.pNext = &present_id_info;
+
     auto result = vkQueuePresentKHR(device.getPresentQueue(), &present_info);
 
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    if (waitForPresent != nullptr && (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR))
+        presentId = present_id;
+
+    currentFrame = (currentFrame + 1) % framesInFlight;
 
     return result;
 }
@@ -108,6 +169,15 @@ VkResult vk::Swapchain::acquireNextImage(uint32_t &image_index)
     vkWaitForFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame], VK_TRUE,
                     std::numeric_limits<uint64_t>::max());
 
+    // Offscreen images are used round robin, submitCommandBuffers() waits for the one handed out to be free
+    if (device.isHeadless())
+    {
+        image_index = nextHeadlessImage;
+        nextHeadlessImage = (nextHeadlessImage + 1) % static_cast<uint32_t>(images.size());
+
+        return VK_SUCCESS;
+    }
+
     VkResult result = vkAcquireNextImageKHR(device.getLogicalDevice(), swapchain, std::numeric_limits<uint64_t>::max(),
                                             imageAvailableSemaphores[currentFrame], // must be a not signaled semaphore
                                             VK_NULL_HANDLE, &image_index);
@@ -115,6 +185,22 @@ VkResult vk::Swapchain::acquireNextImage(uint32_t &image_index)
     return result;
 }
 
+void vk::Swapchain::waitForLastSubmission()
+{
+    const size_t last_frame = (currentFrame + framesInFlight - 1) % framesInFlight;
+
+    vkWaitForFences(device.getLogicalDevice(), 1, &inFlightFences[last_frame], VK_TRUE,
+                    std::numeric_limits<uint64_t>::max());
+}
+
+const bool vk::Swapchain::waitForLastPresent(const uint64_t timeout)
+{
+    if (waitForPresent == nullptr || presentId == 0)
+        return false;
+
+    return waitForPresent(device.getLogicalDevice(), swapchain, presentId, timeout) == VK_SUCCESS;
+}
+
 VkFormat vk::Swapchain::findDepthFormat()
 {
     return device.findSupportedFormat({VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
@@ -123,7 +209,8 @@ VkFormat vk::Swapchain::findDepthFormat()
 
 const bool vk::Swapchain::compatibleWith(Swapchain &other) const
 {
-    return this->imageFormat == other.getImageFormat() && this->depthFormat == other.getDepthFormat();
+    return this->imageFormat == other.getImageFormat() && this->depthFormat == other.getDepthFormat() &&
+           this->renderPath == other.getRenderPath() && this->renderingMode == other.getRenderingMode();
 }
 
 VkSwapchainKHR vk::Swapchain::getHandle()
@@ -131,6 +218,16 @@ VkSwapchainKHR vk::Swapchain::getHandle()
     return swapchain;
 }
 
+const bool vk::Swapchain::isHeadless() const
+{
+    return device.isHeadless();
+}
+
+const VkImageLayout vk::Swapchain::getFinalLayout() const
+{
+    return device.isHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 VkFramebuffer vk::Swapchain::getFramebuffer(const int index)
 {
     return framebuffers[index];
@@ -141,6 +238,11 @@ VkRenderPass vk::Swapchain::getRenderPass()
     return renderPass;
 }
 
+VkImage vk::Swapchain::getImage(const int index)
+{
+    return images[index];
+}
+
 VkImageView vk::Swapchain::getImageView(const int index)
 {
     return imageViews[index];
@@ -151,6 +253,11 @@ const size_t vk::Swapchain::getImageCount()
     return images.size();
 }
 
+const uint32_t vk::Swapchain::getFramesInFlight() const
+{
+    return framesInFlight;
+}
+
 VkFormat vk::Swapchain::getImageFormat()
 {
     return imageFormat;
@@ -171,6 +278,79 @@ const float vk::Swapchain::getExtentAspectRatio()
     return static_cast<float>(extent.width) / static_cast<float>(extent.height);
 }
 
+const vk::Swapchain::RenderPath &vk::Swapchain::getRenderPath() const
+{
+    return renderPath;
+}
+
+const vk::Swapchain::RenderingMode &vk::Swapchain::getRenderingMode() const
+{
+    return renderingMode;
+}
+
+const VkSampleCountFlagBits vk::Swapchain::getSampleCount() const
+{
+    return renderPath == RenderPath::Deferred ? VK_SAMPLE_COUNT_1_BIT : device.getCurrentMsaaSamples();
+}
+
+const uint32_t vk::Swapchain::getAttachmentCount() const
+{
+    // Deferred: color, depth, albedo, normal. Forward: color, depth and the resolve target when multisampled.
+    if (renderPath == RenderPath::Deferred)
+        return 4;
+
+    return device.getCurrentMsaaSamples() != VK_SAMPLE_COUNT_1_BIT ? 3 : 2;
+}
+
+VkImage vk::Swapchain::getDepthImage(const int index)
+{
+    return depthImages[index];
+}
+
+VkImageView vk::Swapchain::getDepthImageView(const int index)
+{
+    return depthImageViews[index];
+}
+
+VkImage vk::Swapchain::getColorImage()
+{
+    return colorImage;
+}
+
+VkImageView vk::Swapchain::getColorImageView()
+{
+    return colorImageView;
+}
+
+const bool vk::Swapchain::hasInternalTarget() const
+{
+    return internalTarget;
+}
+
+VkImage vk::Swapchain::getInternalImage(const int index)
+{
+    assert(internalTarget && "SWAPCHAIN HAS NO INTERNAL TARGET");
+
+    return internalImages[index];
+}
+
+VkImageView vk::Swapchain::getInternalImageView(const int index)
+{
+    assert(internalTarget && "SWAPCHAIN HAS NO INTERNAL TARGET");
+
+    return internalImageViews[index];
+}
+
+VkImageView vk::Swapchain::getAlbedoImageView()
+{
+    return albedoImageView;
+}
+
+VkImageView vk::Swapchain::getNormalImageView()
+{
+    return normalImageView;
+}
+
 const uint32_t vk::Swapchain::getWidth()
 {
     return extent.width;
@@ -181,18 +361,54 @@ const uint32_t vk::Swapchain::getHeight()
     return extent.height;
 }
 
-void vk::Swapchain::init(const PresentMode &preferred_present_mode)
+void vk::Swapchain::init(const PresentMode &preferred_present_mode, const uint32_t preferred_image_count)
 {
-    createSwapchain(preferred_present_mode);
+    assert(framesInFlight > 0 && "AT LEAST ONE FRAME MUST BE IN FLIGHT");
+
+    // The deferred path relies on subpasses and input attachments
+    if (renderingMode == RenderingMode::Dynamic && renderPath == RenderPath::Deferred)
+        throw std::runtime_error("vk::Swapchain::init: DYNAMIC RENDERING DOES NOT SUPPORT THE DEFERRED RENDER PATH");
+
+    // Render passes have the swapchain image baked into their framebuffers
+    if (internalTarget && renderingMode != RenderingMode::Dynamic)
+        throw std::runtime_error("vk::Swapchain::init: AN INTERNAL TARGET REQUIRES DYNAMIC RENDERING");
+
+    if (device.isHeadless())
+        createHeadlessImages(preferred_image_count);
+    else
+        createSwapchain(preferred_present_mode, preferred_image_count);
+
     createImageViews();
-    createRenderPass();
-    createColorResources();
+    if (renderPath == RenderPath::Deferred)
+    {
+        createDeferredRenderPass();
+        createGBufferResources();
+    }
+    else
+    {
+        if (renderingMode == RenderingMode::RenderPass)
+            createRenderPass();
+
+        createColorResources();
+
+        if (internalTarget)
+            createInternalTargetResources();
+    }
+
     createDepthResources();
-    createFramebuffers();
+
+    if (renderingMode == RenderingMode::RenderPass)
+        createFramebuffers();
+
     createSyncObjects();
+
+    // An extension function, so it has to be loaded from the device
+    if (device.supportsPresentWait())
+        waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(device.getLogicalDevice(), "vkWaitForPresentKHR"));
 }
 
-void vk::Swapchain::createSwapchain(const PresentMode &preferred_present_mode)
+void vk::Swapchain::createSwapchain(const PresentMode &preferred_present_mode, const uint32_t preferred_image_count)
 {
     Device::SwapchainSupportDetails swapchainSupport = device.getSwapchainSupport();
 
@@ -200,12 +416,11 @@ void vk::Swapchain::createSwapchain(const PresentMode &preferred_present_mode)
     VkPresentModeKHR presentMode = choosePresentMode(swapchainSupport.presentModes, preferred_present_mode);
     VkExtent2D extent = chooseExtent(swapchainSupport.capabilities);
 
-    uint32_t image_count = swapchainSupport.capabilities.minImageCount + 1;
+    uint32_t image_count = preferred_image_count == 0 ? swapchainSupport.capabilities.minImageCount + 1
+                                                      : std::max(preferred_image_count,
+                                                                 swapchainSupport.capabilities.minImageCount);
     if (swapchainSupport.capabilities.maxImageCount > 0 && image_count > swapchainSupport.capabilities.maxImageCount)
         image_count = swapchainSupport.capabilities.maxImageCount;
-    
-    if (image_count > MAX_FRAMES_IN_FLIGHT)
-        image_count = MAX_FRAMES_IN_FLIGHT;
 
     VkSwapchainCreateInfoKHR swapchain_info = {};
     swapchain_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -255,6 +470,47 @@ void vk::Swapchain::createSwapchain(const PresentMode &preferred_present_mode)
 
     imageFormat = surfaceFormat.format;
     this->extent = extent;
+
+#ifndef NDEBUG
+    std::cout << "USING " << image_count << " SWAPCHAIN IMAGES, " << framesInFlight << " FRAMES IN FLIGHT" << std::endl;
+#endif
+}
+
+void vk::Swapchain::createHeadlessImages(const uint32_t preferred_image_count)
+{
+    const uint32_t image_count = preferred_image_count == 0 ? framesInFlight : preferred_image_count;
+
+    imageFormat = HEADLESS_IMAGE_FORMAT;
+    extent = window.getExtent();
+
+    images.resize(image_count);
+    imageAllocations.resize(image_count);
+
+    for (uint32_t i = 0; i < image_count; i++)
+    {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.extent.width = extent.width;
+        image_info.extent.height = extent.height;
+        image_info.extent.depth = 1;
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.format = imageFormat;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.flags = 0;
+
+        device.createImageWithInfo(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, images[i], imageAllocations[i]);
+    }
+
+#ifndef NDEBUG
+    std::cout << "HEADLESS: USING " << image_count << " OFFSCREEN IMAGES, " << framesInFlight << " FRAMES IN FLIGHT"
+              << std::endl;
+#endif
 }
 
 void vk::Swapchain::createImageViews()
@@ -305,7 +561,7 @@ void vk::Swapchain::createRenderPass()
     color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     color_attachment.finalLayout = device.getCurrentMsaaSamples() != VK_SAMPLE_COUNT_1_BIT
                                        ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-                                       : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+                                       : getFinalLayout();
 
     VkAttachmentReference color_attachment_ref = {};
     color_attachment_ref.attachment = 0;
@@ -319,7 +575,7 @@ void vk::Swapchain::createRenderPass()
     color_attachment_resolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     color_attachment_resolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     color_attachment_resolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color_attachment_resolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color_attachment_resolve.finalLayout = getFinalLayout();
 
     VkAttachmentReference color_attachment_resolve_ref{};
     color_attachment_resolve_ref.attachment = 2;
@@ -362,6 +618,118 @@ void vk::Swapchain::createRenderPass()
         throw std::runtime_error("vk::Swapchain::createRenderPass: FAILED TO CREATE RENDER PASS");
 }
 
+void vk::Swapchain::createDeferredRenderPass()
+{
+    // Attachments: 0 = swapchain color, 1 = depth, 2 = albedo, 3 = normal
+    VkAttachmentDescription color_attachment = {};
+    color_attachment.format = getImageFormat();
+    color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment.finalLayout = getFinalLayout();
+
+    VkAttachmentDescription depth_attachment = {};
+    depth_attachment.format = findDepthFormat();
+    depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth_attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    // G-buffer contents never leave the render pass
+    VkAttachmentDescription albedo_attachment = color_attachment;
+    albedo_attachment.format = GBUFFER_ALBEDO_FORMAT;
+    albedo_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    albedo_attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription normal_attachment = albedo_attachment;
+    normal_attachment.format = GBUFFER_NORMAL_FORMAT;
+
+    /* GEOMETRY SUBPASS ------------------------------------------------------------------------------------- */
+
+    std::array<VkAttachmentReference, 2> gbuffer_refs = {};
+    gbuffer_refs[0] = {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    gbuffer_refs[1] = {3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkAttachmentReference depth_write_ref = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    /* LIGHTING SUBPASS ------------------------------------------------------------------------------------- */
+
+    VkAttachmentReference color_ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    // Order matches the input_attachment_index of the lighting shader
+    std::array<VkAttachmentReference, 3> input_refs = {};
+    input_refs[0] = {2, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    input_refs[1] = {3, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    input_refs[2] = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+
+    // Read-only depth lets forward-rendered extras (light billboards) depth test against the scene
+    VkAttachmentReference depth_read_ref = {1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+
+    std::array<VkSubpassDescription, 2> subpasses = {};
+
+    subpasses[GEOMETRY_SUBPASS].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[GEOMETRY_SUBPASS].colorAttachmentCount = static_cast<uint32_t>(gbuffer_refs.size());
+    subpasses[GEOMETRY_SUBPASS].pColorAttachments = gbuffer_refs.data();
+    subpasses[GEOMETRY_SUBPASS].pDepthStencilAttachment = &depth_write_ref;
+
+    subpasses[LIGHTING_SUBPASS].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[LIGHTING_SUBPASS].colorAttachmentCount = 1;
+    subpasses[LIGHTING_SUBPASS].pColorAttachments = &color_ref;
+    subpasses[LIGHTING_SUBPASS].inputAttachmentCount = static_cast<uint32_t>(input_refs.size());
+    subpasses[LIGHTING_SUBPASS].pInputAttachments = input_refs.data();
+    subpasses[LIGHTING_SUBPASS].pDepthStencilAttachment = &depth_read_ref;
+
+    std::array<VkSubpassDependency, 2> dependencies = {};
+
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = GEOMETRY_SUBPASS;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // By region: each pixel only reads its own G-buffer texel, which is what keeps the data on-chip
+    dependencies[1].srcSubpass = GEOMETRY_SUBPASS;
+    dependencies[1].dstSubpass = LIGHTING_SUBPASS;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstAccessMask =
+        VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    std::array<VkAttachmentDescription, 4> attachments = {color_attachment, depth_attachment, albedo_attachment,
+                                                          normal_attachment};
+
+    VkRenderPassCreateInfo render_pass_info = {};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+    render_pass_info.pAttachments = attachments.data();
+    render_pass_info.subpassCount = static_cast<uint32_t>(subpasses.size());
+    render_pass_info.pSubpasses = subpasses.data();
+    render_pass_info.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    render_pass_info.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(device.getLogicalDevice(), &render_pass_info, nullptr, &renderPass) != VK_SUCCESS)
+        throw std::runtime_error("vk::Swapchain::createDeferredRenderPass: FAILED TO CREATE RENDER PASS");
+}
+
 void vk::Swapchain::createFramebuffers()
 {
     framebuffers.resize(getImageCount());
@@ -370,7 +738,9 @@ void vk::Swapchain::createFramebuffers()
     {
         std::vector<VkImageView> attachments;
 
-        if (device.getCurrentMsaaSamples() != VK_SAMPLE_COUNT_1_BIT)
+        if (renderPath == RenderPath::Deferred)
+            attachments = {imageViews[i], depthImageViews[i], albedoImageView, normalImageView};
+        else if (device.getCurrentMsaaSamples() != VK_SAMPLE_COUNT_1_BIT)
             attachments = {colorImageView, depthImageViews[i], imageViews[i]};
         else
             attachments = {imageViews[i], depthImageViews[i]};
@@ -428,6 +798,97 @@ void vk::Swapchain::createColorResources()
         throw std::runtime_error("vk::Swapchain::createColorResources: FAILED TO CREATE COLOR IMAGE VIEW");
 }
 
+void vk::Swapchain::createInternalTargetResources()
+{
+    VkExtent2D swapchain_extent = getExtent();
+
+    internalImages.resize(getImageCount());
+    internalImageAllocations.resize(getImageCount());
+    internalImageViews.resize(getImageCount());
+
+    for (int i = 0; i < internalImages.size(); i++)
+    {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.extent.width = swapchain_extent.width;
+        image_info.extent.height = swapchain_extent.height;
+        image_info.extent.depth = 1;
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.format = imageFormat;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.flags = 0;
+
+        device.createImageWithInfo(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, internalImages[i],
+                                   internalImageAllocations[i]);
+
+        VkImageViewCreateInfo view_info{};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = internalImages[i];
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = imageFormat;
+        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        view_info.subresourceRange.baseMipLevel = 0;
+        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.baseArrayLayer = 0;
+        view_info.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(device.getLogicalDevice(), &view_info, nullptr, &internalImageViews[i]) != VK_SUCCESS)
+            throw std::runtime_error(
+                "vk::Swapchain::createInternalTargetResources: FAILED TO CREATE INTERNAL TARGET IMAGE VIEW");
+    }
+}
+
+void vk::Swapchain::createGBufferResources()
+{
+    createGBufferImage(GBUFFER_ALBEDO_FORMAT, albedoImage, albedoImageAllocation, albedoImageView);
+    createGBufferImage(GBUFFER_NORMAL_FORMAT, normalImage, normalImageAllocation, normalImageView);
+}
+
+void vk::Swapchain::createGBufferImage(const VkFormat format, VkImage &image, VmaAllocation &allocation,
+                                       VkImageView &view)
+{
+    VkExtent2D swapchain_extent = getExtent();
+
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent.width = swapchain_extent.width;
+    image_info.extent.height = swapchain_extent.height;
+    image_info.extent.depth = 1;
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.format = format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                       VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.flags = 0;
+
+    device.createImageWithInfo(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, allocation);
+
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device.getLogicalDevice(), &view_info, nullptr, &view) != VK_SUCCESS)
+        throw std::runtime_error("vk::Swapchain::createGBufferImage: FAILED TO CREATE G-BUFFER IMAGE VIEW");
+}
+
 void vk::Swapchain::createDepthResources()
 {
     depthFormat = findDepthFormat();
@@ -451,7 +912,11 @@ void vk::Swapchain::createDepthResources()
         image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
         image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         image_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-        image_info.samples = device.getCurrentMsaaSamples();
+        image_info.samples = getSampleCount();
+
+        // The lighting subpass reads depth back to reconstruct positions
+        if (renderPath == RenderPath::Deferred)
+            image_info.usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
         image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         image_info.flags = 0;
 
@@ -476,9 +941,9 @@ void vk::Swapchain::createDepthResources()
 
 void vk::Swapchain::createSyncObjects()
 {
-    imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    imageAvailableSemaphores.resize(framesInFlight);
+    inFlightFences.resize(framesInFlight);
+    renderFinishedSemaphores.resize(getImageCount());
     imagesInFlight.resize(getImageCount(), VK_NULL_HANDLE);
 
     VkSemaphoreCreateInfo semaphore_info = {};
@@ -488,17 +953,21 @@ void vk::Swapchain::createSyncObjects()
     fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (size_t i = 0; i < framesInFlight; i++)
     {
         if (vkCreateSemaphore(device.getLogicalDevice(), &semaphore_info, nullptr, &imageAvailableSemaphores[i]) !=
                 VK_SUCCESS ||
-            vkCreateSemaphore(device.getLogicalDevice(), &semaphore_info, nullptr, &renderFinishedSemaphores[i]) !=
-                VK_SUCCESS ||
             vkCreateFence(device.getLogicalDevice(), &fence_info, nullptr, &inFlightFences[i]) != VK_SUCCESS)
         {
             throw std::runtime_error("vk::Swapchain::createSyncObjects: FAILED TO CREATE SYNCRONIZATION OBJECTS");
         }
     }
+
+    for (auto &semaphore : renderFinishedSemaphores)
+    {
+        if (vkCreateSemaphore(device.getLogicalDevice(), &semaphore_info, nullptr, &semaphore) != VK_SUCCESS)
+            throw std::runtime_error("vk::Swapchain::createSyncObjects: FAILED TO CREATE SYNCRONIZATION OBJECTS");
+    }
 }
 
 VkSurfaceFormatKHR vk::Swapchain::chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &available_formats)
@@ -1,8 +1,12 @@
 #include "SVKE/Core/System/Window.hpp"
 
-vk::Window::Window(const int width, const int height, const std::string &title)
-    : window(nullptr), width(width), height(height), title(title), framebufferResized(false), fullscreen(false)
+vk::Window::Window(const int width, const int height, const std::string &title, const bool headless)
+    : window(nullptr), monitor(nullptr), width(width), height(height), x(0), y(0), title(title),
+      framebufferResized(false), fullscreen(false), headless(headless)
 {
+    if (headless)
+        return;
+
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
@@ -17,14 +21,25 @@ vk::Window::Window(const int width, const int height, const std::string &title)
 
 vk::Window::~Window()
 {
+    if (headless)
+        return;
+
     if (window)
         glfwDestroyWindow(window);
 
     glfwTerminate();
 }
 
+const bool vk::Window::isHeadless() const
+{
+    return headless;
+}
+
 const bool vk::Window::shouldClose() const
 {
+    if (headless)
+        return false;
+
     assert(window != nullptr && "WINDOW HANDLE IS NULL");
 
     return glfwWindowShouldClose(window);
@@ -32,6 +47,7 @@ const bool vk::Window::shouldClose() const
 
 void vk::Window::createSurface(VkInstance &instance, VkSurfaceKHR &surface)
 {
+    assert(!headless && "A HEADLESS WINDOW HAS NO SURFACE");
     assert(window != nullptr && "WINDOW HANDLE IS NULL");
 
     glfwCreateWindowSurface(instance, window, nullptr, &surface);
@@ -39,6 +55,9 @@ void vk::Window::createSurface(VkInstance &instance, VkSurfaceKHR &surface)
 
 void vk::Window::pollEvents()
 {
+    if (headless)
+        return;
+
     assert(window != nullptr && "WINDOW HANDLE IS NULL");
 
     glfwPollEvents();
@@ -53,39 +72,49 @@ GLFWwindow *&vk::Window::getHandle()
 
 const uint32_t vk::Window::getWidth() const
 {
-    assert(window != nullptr && "WINDOW HANDLE IS NULL");
+    assert((headless || window != nullptr) && "WINDOW HANDLE IS NULL");
 
     return static_cast<uint32_t>(width);
 }
 
 const uint32_t vk::Window::getHeight() const
 {
-    assert(window != nullptr && "WINDOW HANDLE IS NULL");
+    assert((headless || window != nullptr) && "WINDOW HANDLE IS NULL");
 
     return static_cast<uint32_t>(width);
 }
 
 VkExtent2D vk::Window::getExtent() const
 {
-    assert(window != nullptr && "WINDOW HANDLE IS NULL");
+    assert((headless || window != nullptr) && "WINDOW HANDLE IS NULL");
 
     return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
 }
 
 const bool vk::Window::wasResized() const
 {
-    assert(window != nullptr && "WINDOW HANDLE IS NULL");
+    assert((headless || window != nullptr) && "WINDOW HANDLE IS NULL");
 
     return framebufferResized;
 }
 
 const bool vk::Window::isFullscreen() const
 {
-    assert(window != nullptr && "WINDOW HANDLE IS NULL");
+    assert((headless || window != nullptr) && "WINDOW HANDLE IS NULL");
 
     return fullscreen;
 }
 
+const int vk::Window::getRefreshRate() const
+{
+    if (headless)
+        return 60;
+
+    const GLFWvidmode *mode = glfwGetVideoMode(monitor);
+
+    return mode != nullptr ? mode->refreshRate : 60;
+}
+
 void vk::Window::setResized(const bool resized)
 {
     assert(window != nullptr && "WINDOW HANDLE IS NULL");
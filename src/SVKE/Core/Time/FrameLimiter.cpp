@@ -0,0 +1,50 @@
+#include "SVKE/Core/Time/FrameLimiter.hpp"
+
+#include <thread>
+
+vk::FrameLimiter::FrameLimiter(const float target_rate)
+{
+    setTargetRate(target_rate);
+}
+
+void vk::FrameLimiter::setTargetRate(const float target_rate)
+{
+    targetRate = target_rate > 0.f ? target_rate : 0.f;
+    period = targetRate > 0.f ? std::chrono::duration_cast<clock_t::duration>(
+                                    std::chrono::duration<double>(1.0 / static_cast<double>(targetRate)))
+                              : clock_t::duration::zero();
+    deadline = clock_t::now();
+}
+
+const float vk::FrameLimiter::getTargetRate() const
+{
+    return targetRate;
+}
+
+const bool vk::FrameLimiter::isEnabled() const
+{
+    return targetRate > 0.f;
+}
+
+void vk::FrameLimiter::wait()
+{
+    if (!isEnabled())
+        return;
+
+    deadline += period;
+
+    auto now = clock_t::now();
+
+    // Missed by more than a frame: start a new schedule from here
+    if (now > deadline + period)
+    {
+        deadline = now;
+        return;
+    }
+
+    if (deadline - now > SPIN_THRESHOLD)
+        std::this_thread::sleep_for(deadline - now - SPIN_THRESHOLD);
+
+    while (clock_t::now() < deadline)
+        std::this_thread::yield();
+}
@@ -0,0 +1,171 @@
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+// Zone names are code, but a stray quote or backslash must not break the JSON
+void writeEscaped(std::ostream &stream, const std::string &text)
+{
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            stream << ' ';
+        else
+            stream << c;
+    }
+}
+} // namespace
+
+/* ZONE ------------------------------------------------------------------------------------------------------- */
+
+vk::Profiler::Zone::Zone(const char *name) : name(name), start(-1)
+{
+    if (isEnabled())
+        start = now();
+}
+
+vk::Profiler::Zone::~Zone()
+{
+    if (start >= 0)
+        record(name, start, now());
+}
+
+/* PROFILER --------------------------------------------------------------------------------------------------- */
+
+void vk::Profiler::setEnabled(const bool enabled)
+{
+    getRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+const bool vk::Profiler::isEnabled()
+{
+    return getRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+void vk::Profiler::setThreadName(const std::string &name)
+{
+    ThreadBuffer &buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+void vk::Profiler::clear()
+{
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+
+    for (auto &buffer : registry.buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->next = 0;
+        buffer->count = 0;
+    }
+}
+
+const bool vk::Profiler::writeChromeTrace(const std::string &path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        std::cerr << "vk::Profiler::writeChromeTrace: FAILED TO OPEN " << path << std::endl;
+        return false;
+    }
+
+    // Chrome trace timestamps are in microseconds
+    file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    const auto separator = [&]() {
+        if (!first)
+            file << ",";
+        first = false;
+        file << "\n";
+    };
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+
+    for (auto &buffer : registry.buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        if (!buffer->threadName.empty())
+        {
+            separator();
+            file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":" << buffer->threadId
+                 << ",\"args\":{\"name\":\"";
+            writeEscaped(file, buffer->threadName);
+            file << "\"}}";
+        }
+
+        // Oldest first, the ring starts at next once it has wrapped
+        const size_t first_event = buffer->count == RING_SIZE ? buffer->next : 0;
+
+        for (size_t i = 0; i < buffer->count; ++i)
+        {
+            const Event &event = buffer->events[(first_event + i) % RING_SIZE];
+
+            separator();
+            file << "{\"ph\":\"X\",\"cat\":\"cpu\",\"name\":\"";
+            writeEscaped(file, event.name);
+            file << "\",\"pid\":0,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << static_cast<double>(event.start) * 1e-3
+                 << ",\"dur\":" << static_cast<double>(event.duration) * 1e-3 << "}";
+        }
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+vk::Profiler::Registry &vk::Profiler::getRegistry()
+{
+    // Never destroyed, threads may still close zones while static objects are torn down
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+vk::Profiler::ThreadBuffer &vk::Profiler::getThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(RING_SIZE);
+
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        buffer->threadId = static_cast<uint32_t>(registry.buffers.size());
+        registry.buffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+const int64_t vk::Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - getRegistry().epoch).count();
+}
+
+void vk::Profiler::record(const char *name, const int64_t start, const int64_t end)
+{
+    ThreadBuffer &buffer = getThreadBuffer();
+
+    // Only contended while a trace is written
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    buffer.events[buffer.next] = {name, start, end - start};
+    buffer.next = (buffer.next + 1) % RING_SIZE;
+    buffer.count = std::min(buffer.count + 1, RING_SIZE);
+}
@@ -0,0 +1,64 @@
+#include "SVKE/Rendering/DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+vk::DynamicResolution::DynamicResolution() : DynamicResolution(Config{})
+{
+}
+
+vk::DynamicResolution::DynamicResolution(const Config &config)
+{
+    setConfig(config);
+}
+
+const float vk::DynamicResolution::update(const float gpu_frame_time)
+{
+    if (gpu_frame_time <= 0.f)
+        return scale;
+
+    smoothedFrameTime = smoothedFrameTime > 0.f
+                            ? smoothedFrameTime + (gpu_frame_time - smoothedFrameTime) * config.smoothing
+                            : gpu_frame_time;
+
+    const float ratio = config.targetFrameTime / smoothedFrameTime;
+
+    if (std::abs(ratio - 1.f) <= config.deadband)
+        return scale;
+
+    const float ideal = scale * std::sqrt(ratio);
+    scale = std::clamp(scale + (ideal - scale) * config.responsiveness, config.minScale, config.maxScale);
+
+    return scale;
+}
+
+void vk::DynamicResolution::reset()
+{
+    scale = config.maxScale;
+    smoothedFrameTime = 0.f;
+}
+
+void vk::DynamicResolution::setConfig(const Config &config)
+{
+    assert(config.targetFrameTime > 0.f && "TARGET FRAME TIME MUST BE POSITIVE");
+    assert(config.minScale > 0.f && config.minScale <= config.maxScale && "INVALID SCALE RANGE");
+
+    this->config = config;
+    reset();
+}
+
+const vk::DynamicResolution::Config &vk::DynamicResolution::getConfig() const
+{
+    return config;
+}
+
+const float vk::DynamicResolution::getScale() const
+{
+    return scale;
+}
+
+const float vk::DynamicResolution::getSmoothedFrameTime() const
+{
+    return smoothedFrameTime;
+}
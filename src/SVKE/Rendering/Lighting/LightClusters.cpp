@@ -0,0 +1,294 @@
+#include "SVKE/Rendering/Lighting/LightClusters.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Writes the part of data that differs from uploaded, which mirrors the buffer's contents, and flushes it.
+// Returns the number of bytes written.
+template <typename T>
+const VkDeviceSize uploadChanged(vk::Buffer &buffer, std::vector<T> &uploaded, const std::vector<T> &data)
+{
+    const size_t common = std::min(uploaded.size(), data.size());
+
+    size_t first = 0;
+    while (first < common && std::memcmp(&uploaded[first], &data[first], sizeof(T)) == 0)
+        ++first;
+
+    // Elements past the previous size are always new
+    size_t last = data.size();
+    if (last <= uploaded.size())
+    {
+        while (last > first && std::memcmp(&uploaded[last - 1], &data[last - 1], sizeof(T)) == 0)
+            --last;
+    }
+
+    VkDeviceSize size = 0;
+
+    if (first < last)
+    {
+        const VkDeviceSize offset = sizeof(T) * first;
+        size = sizeof(T) * (last - first);
+
+        buffer.write(data.data() + first, size, offset);
+        buffer.flush(size, offset);
+    }
+
+    uploaded.assign(data.begin(), data.end());
+
+    return size;
+}
+} // namespace
+
+vk::LightClusters::LightClusters(Device &device, const uint32_t frames_in_flight)
+    : device(device), frames(frames_in_flight), uploadedBytes(0)
+{
+    lights.reserve(64);
+    clusters.resize(CLUSTER_COUNT);
+
+    for (auto &frame : frames)
+    {
+        frame.clusters = createBuffer(sizeof(Cluster) * CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        frame.lighting = createBuffer(sizeof(LightingUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+        reserve(frame, 64, 4096);
+    }
+}
+
+void vk::LightClusters::beginLights()
+{
+    lights.clear();
+}
+
+void vk::LightClusters::addLight(const Vec3f &position, const Color &color, const float intensity)
+{
+    GpuPointLight light = {};
+    light.position = Vec4f{position, computeLightRange(color, intensity)};
+    light.color = Vec4f{color.toVec3(), intensity};
+
+    lights.push_back(light);
+}
+
+void vk::LightClusters::setAmbientLight(const Color &color, const float intensity)
+{
+    lighting.ambientLightColor = Vec4f{color.toVec3(), intensity};
+}
+
+const bool vk::LightClusters::update(const int frame_index, const Camera &camera, const VkExtent2D &extent)
+{
+    SVKE_PROFILE_ZONE("vk::LightClusters::update");
+
+    assert(frame_index >= 0 && frame_index < frames.size() && "FRAME INDEX IS OUT OF BOUNDS");
+
+    binLights(camera);
+
+    lighting.grid.dimensions.w = static_cast<uint32_t>(lights.size());
+    lighting.grid.parameters.z = 1.f / static_cast<float>(std::max(extent.width, 1u));
+    lighting.grid.parameters.w = 1.f / static_cast<float>(std::max(extent.height, 1u));
+
+    FrameBuffers &frame = frames[frame_index];
+    const bool reallocated = reserve(frame, lights.size(), lightIndices.size());
+
+    uploadedBytes = uploadChanged(*frame.lights, frame.uploadedLights, lights);
+    uploadedBytes += uploadChanged(*frame.clusters, frame.uploadedClusters, clusters);
+    uploadedBytes += uploadChanged(*frame.lightIndices, frame.uploadedLightIndices, lightIndices);
+
+    frame.lighting->write(&lighting, sizeof(LightingUBO));
+    frame.lighting->flush();
+    uploadedBytes += sizeof(LightingUBO);
+
+    return reallocated;
+}
+
+const VkDeviceSize vk::LightClusters::getUploadedBytes() const
+{
+    return uploadedBytes;
+}
+
+const vk::LightClusters::GridInfo &vk::LightClusters::getGridInfo() const
+{
+    return lighting.grid;
+}
+
+const size_t vk::LightClusters::getLightCount() const
+{
+    return lights.size();
+}
+
+VkDescriptorBufferInfo vk::LightClusters::getLightsDescriptorInfo(const int frame_index)
+{
+    return frames[frame_index].lights->getDescriptorInfo();
+}
+
+VkDescriptorBufferInfo vk::LightClusters::getClustersDescriptorInfo(const int frame_index)
+{
+    return frames[frame_index].clusters->getDescriptorInfo();
+}
+
+VkDescriptorBufferInfo vk::LightClusters::getLightIndicesDescriptorInfo(const int frame_index)
+{
+    return frames[frame_index].lightIndices->getDescriptorInfo();
+}
+
+VkDescriptorBufferInfo vk::LightClusters::getLightingDescriptorInfo(const int frame_index)
+{
+    return frames[frame_index].lighting->getDescriptorInfo();
+}
+
+const float vk::LightClusters::computeLightRange(const Color &color, const float intensity)
+{
+    const Vec3f rgb = color.toVec3();
+    const float brightest = std::max(rgb.r, std::max(rgb.g, rgb.b)) * intensity;
+
+    return std::sqrt(std::max(brightest, 0.f) / LIGHT_CUTOFF);
+}
+
+void vk::LightClusters::binLights(const Camera &camera)
+{
+    const Mat4f &projection = camera.getProjectionMatrix();
+    const Mat4f &view = camera.getViewMatrix();
+
+    // Recover the clip planes from the projection built by Camera::setPerspectiveProjection
+    const float near = -projection[3][2] / projection[2][2];
+    const float far = projection[3][2] / (1.f - projection[2][2]);
+    const float x_scale = projection[0][0];
+    const float y_scale = projection[1][1];
+
+    // Exponential slices: slice = log(z) * scale - bias, so every slice has the same depth ratio
+    const float log_ratio = std::log(far / near);
+    const float slice_scale = static_cast<float>(GRID_Z) / log_ratio;
+    const float slice_bias = static_cast<float>(GRID_Z) * std::log(near) / log_ratio;
+
+    lighting.grid.parameters.x = slice_scale;
+    lighting.grid.parameters.y = slice_bias;
+
+    const auto slice_of = [&](const float z) {
+        const int slice = static_cast<int>(std::floor(std::log(z) * slice_scale - slice_bias));
+        return static_cast<uint32_t>(std::clamp(slice, 0, static_cast<int>(GRID_Z) - 1));
+    };
+
+    const auto slice_depth = [&](const uint32_t slice) {
+        return near * std::pow(far / near, static_cast<float>(slice) / static_cast<float>(GRID_Z));
+    };
+
+    // Maps an NDC range to the tiles it covers, returns false if it is off screen
+    const auto tile_range = [](float ndc_min, float ndc_max, const uint32_t tiles, uint32_t &first, uint32_t &last) {
+        if (ndc_max < -1.f || ndc_min > 1.f)
+            return false;
+
+        ndc_min = std::max(ndc_min, -1.f);
+        ndc_max = std::min(ndc_max, 1.f);
+
+        first = std::min(static_cast<uint32_t>((ndc_min * .5f + .5f) * tiles), tiles - 1);
+        last = std::min(static_cast<uint32_t>((ndc_max * .5f + .5f) * tiles), tiles - 1);
+        return true;
+    };
+
+    assignments.clear();
+
+    for (uint32_t light_index = 0; light_index < lights.size(); ++light_index)
+    {
+        const GpuPointLight &light = lights[light_index];
+        const Vec3f center = Vec3f{view * Vec4f{Vec3f{light.position}, 1.f}};
+        const float range = light.position.w;
+
+        if (center.z + range < near || center.z - range > far)
+            continue;
+
+        const float z_min = std::max(center.z - range, near);
+        const float z_max = std::min(center.z + range, far);
+
+        for (uint32_t slice = slice_of(z_min); slice <= slice_of(z_max); ++slice)
+        {
+            const float z_near = std::max(z_min, slice_depth(slice));
+            const float z_far = std::min(z_max, slice_depth(slice + 1));
+
+            // The light's view-space box projected at both ends of the slice bounds its screen footprint
+            const float x_min = std::min((center.x - range) / z_near, (center.x - range) / z_far) * x_scale;
+            const float x_max = std::max((center.x + range) / z_near, (center.x + range) / z_far) * x_scale;
+            const float y_min = std::min((center.y - range) / z_near, (center.y - range) / z_far) * y_scale;
+            const float y_max = std::max((center.y + range) / z_near, (center.y + range) / z_far) * y_scale;
+
+            uint32_t tile_x_first, tile_x_last, tile_y_first, tile_y_last;
+
+            if (!tile_range(x_min, x_max, GRID_X, tile_x_first, tile_x_last) ||
+                !tile_range(y_min, y_max, GRID_Y, tile_y_first, tile_y_last))
+                continue;
+
+            for (uint32_t tile_y = tile_y_first; tile_y <= tile_y_last; ++tile_y)
+            {
+                for (uint32_t tile_x = tile_x_first; tile_x <= tile_x_last; ++tile_x)
+                    assignments.emplace_back((slice * GRID_Y + tile_y) * GRID_X + tile_x, light_index);
+            }
+        }
+    }
+
+    // Counting sort of the assignments by cluster into one contiguous index list, capped per cluster. Dropped
+    // assignments are marked with an out of range cluster.
+    for (auto &cluster : clusters)
+        cluster = {0, 0};
+
+    for (auto &assignment : assignments)
+    {
+        if (clusters[assignment.first].count < MAX_LIGHTS_PER_CLUSTER)
+            ++clusters[assignment.first].count;
+        else
+            assignment.first = CLUSTER_COUNT;
+    }
+
+    uint32_t offset = 0;
+    for (auto &cluster : clusters)
+    {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0;
+    }
+
+    lightIndices.resize(offset);
+
+    for (const auto &assignment : assignments)
+    {
+        if (assignment.first == CLUSTER_COUNT)
+            continue;
+
+        Cluster &cluster = clusters[assignment.first];
+        lightIndices[cluster.offset + cluster.count++] = assignment.second;
+    }
+}
+
+const bool vk::LightClusters::reserve(FrameBuffers &frame, const size_t light_count, const size_t index_count)
+{
+    bool reallocated = false;
+
+    if (light_count > frame.lightCapacity)
+    {
+        frame.lightCapacity = std::max(light_count, frame.lightCapacity * 2);
+        frame.lights = createBuffer(sizeof(GpuPointLight) * frame.lightCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        frame.uploadedLights.clear();
+        reallocated = true;
+    }
+
+    if (index_count > frame.indexCapacity)
+    {
+        frame.indexCapacity = std::max(index_count, frame.indexCapacity * 2);
+        frame.lightIndices = createBuffer(sizeof(uint32_t) * frame.indexCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        frame.uploadedLightIndices.clear();
+        reallocated = true;
+    }
+
+    return reallocated;
+}
+
+std::unique_ptr<vk::Buffer> vk::LightClusters::createBuffer(const size_t size, VkBufferUsageFlags usage)
+{
+    auto buffer = std::make_unique<Buffer>(device, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                           VMA_MEMORY_USAGE_AUTO,
+                                           VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                                               VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    buffer->map();
+
+    return buffer;
+}
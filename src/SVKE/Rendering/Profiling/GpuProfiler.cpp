@@ -0,0 +1,312 @@
+#include "SVKE/Rendering/Profiling/GpuProfiler.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+// Query results are read straight into PipelineStatistics
+static_assert(sizeof(vk::GpuProfiler::PipelineStatistics) == 6 * sizeof(uint64_t),
+              "PIPELINE STATISTICS MUST MATCH THE QUERY RESULT LAYOUT");
+
+/* SCOPE ------------------------------------------------------------------------------------------------------ */
+
+vk::GpuProfiler::Scope::Scope(GpuProfiler &profiler, VkCommandBuffer command_buffer, const std::string &name,
+                              const bool pipeline_statistics)
+    : profiler(profiler), commandBuffer(command_buffer)
+{
+    profiler.beginScope(commandBuffer, name, pipeline_statistics);
+}
+
+vk::GpuProfiler::Scope::~Scope()
+{
+    profiler.endScope(commandBuffer);
+}
+
+/* PROFILER --------------------------------------------------------------------------------------------------- */
+
+vk::GpuProfiler::GpuProfiler(Device &device, const uint32_t frames_in_flight)
+    : device(device), timestampPeriod(device.getProperties().limits.timestampPeriod), frames(frames_in_flight),
+      currentFrame(-1), statisticsActive(false)
+{
+    // 0 valid bits: the graphics queue cannot write timestamps at all
+    const uint32_t valid_bits = device.getGraphicsTimestampValidBits();
+    supported = valid_bits > 0;
+    timestampMask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+    statisticsSupported = supported && device.supportsPipelineStatistics();
+
+    if (!supported)
+    {
+#ifndef NDEBUG
+        std::cout << "GPU TIMESTAMPS NOT SUPPORTED, GPU PROFILING DISABLED" << std::endl;
+#endif
+        return;
+    }
+
+    VkQueryPoolCreateInfo pool_info = {};
+    pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = 2 * MAX_SCOPES;
+
+    for (auto &frame : frames)
+    {
+        if (vkCreateQueryPool(device.getLogicalDevice(), &pool_info, nullptr, &frame.queryPool) != VK_SUCCESS)
+            throw std::runtime_error("vk::GpuProfiler::GpuProfiler: FAILED TO CREATE TIMESTAMP QUERY POOL");
+
+        frame.scopes.reserve(MAX_SCOPES);
+    }
+
+    timestamps.resize(2 * MAX_SCOPES);
+
+    if (!statisticsSupported)
+    {
+#ifndef NDEBUG
+        std::cout << "PIPELINE STATISTICS QUERIES NOT SUPPORTED, GPU SCOPES ARE ONLY TIMED" << std::endl;
+#endif
+        return;
+    }
+
+    VkQueryPoolCreateInfo statistics_pool_info = {};
+    statistics_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    statistics_pool_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    statistics_pool_info.queryCount = MAX_SCOPES;
+    statistics_pool_info.pipelineStatistics = PIPELINE_STATISTICS;
+
+    for (auto &frame : frames)
+    {
+        if (vkCreateQueryPool(device.getLogicalDevice(), &statistics_pool_info, nullptr, &frame.statisticsPool) !=
+            VK_SUCCESS)
+            throw std::runtime_error("vk::GpuProfiler::GpuProfiler: FAILED TO CREATE PIPELINE STATISTICS QUERY POOL");
+    }
+
+    statisticsResults.resize(MAX_SCOPES);
+}
+
+vk::GpuProfiler::~GpuProfiler()
+{
+    for (auto &frame : frames)
+    {
+        if (frame.queryPool != VK_NULL_HANDLE)
+            vkDestroyQueryPool(device.getLogicalDevice(), frame.queryPool, nullptr);
+
+        if (frame.statisticsPool != VK_NULL_HANDLE)
+            vkDestroyQueryPool(device.getLogicalDevice(), frame.statisticsPool, nullptr);
+    }
+}
+
+const bool vk::GpuProfiler::beginFrame(VkCommandBuffer command_buffer, const int frame_index)
+{
+    assert(frame_index >= 0 && frame_index < frames.size() && "FRAME INDEX IS OUT OF BOUNDS");
+    assert(openScopes.empty() && "PREVIOUS FRAME ENDED WITH OPEN SCOPES");
+
+    if (!supported)
+        return false;
+
+    currentFrame = frame_index;
+    Frame &frame = frames[currentFrame];
+
+    const bool collected = collect(frame);
+
+    vkCmdResetQueryPool(command_buffer, frame.queryPool, 0, 2 * MAX_SCOPES);
+    frame.scopes.clear();
+    frame.queryCount = 0;
+
+    if (statisticsSupported)
+        vkCmdResetQueryPool(command_buffer, frame.statisticsPool, 0, MAX_SCOPES);
+
+    frame.statisticsQueryCount = 0;
+
+    return collected;
+}
+
+void vk::GpuProfiler::beginScope(VkCommandBuffer command_buffer, const std::string &name,
+                                 const bool pipeline_statistics)
+{
+    if (!supported)
+        return;
+
+    assert(currentFrame >= 0 && "CANNOT BEGIN A SCOPE BEFORE THE FIRST FRAME");
+
+    Frame &frame = frames[currentFrame];
+
+    if (frame.scopes.size() == MAX_SCOPES)
+    {
+        openScopes.push_back(DROPPED_SCOPE);
+        return;
+    }
+
+    openScopes.push_back(static_cast<uint32_t>(frame.scopes.size()));
+    frame.scopes.push_back({getScopeId(name), frame.queryCount, NO_STATISTICS_QUERY});
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, frame.queryCount);
+    frame.queryCount += 2;
+
+    // Only scopes that got timestamps get a query, so MAX_SCOPES queries are always enough
+    if (pipeline_statistics && statisticsSupported && !statisticsActive)
+    {
+        frame.scopes.back().statisticsQuery = frame.statisticsQueryCount;
+        vkCmdBeginQuery(command_buffer, frame.statisticsPool, frame.statisticsQueryCount, 0);
+
+        ++frame.statisticsQueryCount;
+        statisticsActive = true;
+    }
+}
+
+void vk::GpuProfiler::endScope(VkCommandBuffer command_buffer)
+{
+    if (!supported)
+        return;
+
+    assert(!openScopes.empty() && "NO SCOPE TO END");
+
+    const uint32_t scope = openScopes.back();
+    openScopes.pop_back();
+
+    if (scope == DROPPED_SCOPE)
+        return;
+
+    Frame &frame = frames[currentFrame];
+
+    if (frame.scopes[scope].statisticsQuery != NO_STATISTICS_QUERY)
+    {
+        vkCmdEndQuery(command_buffer, frame.statisticsPool, frame.scopes[scope].statisticsQuery);
+        statisticsActive = false;
+    }
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool,
+                        frame.scopes[scope].firstQuery + 1);
+}
+
+const bool vk::GpuProfiler::isSupported() const
+{
+    return supported;
+}
+
+const bool vk::GpuProfiler::isPipelineStatisticsSupported() const
+{
+    return statisticsSupported;
+}
+
+const vk::RollingStatistics::Summary vk::GpuProfiler::getStatistics(const std::string &name) const
+{
+    auto it = scopeIds.find(name);
+    if (it == scopeIds.end())
+        return {};
+
+    return histories[it->second].summarize();
+}
+
+const float vk::GpuProfiler::getLastTime(const std::string &name) const
+{
+    auto it = scopeIds.find(name);
+    if (it == scopeIds.end())
+        return 0.f;
+
+    return histories[it->second].getLast();
+}
+
+const vk::GpuProfiler::PipelineStatistics vk::GpuProfiler::getLastPipelineStatistics(const std::string &name) const
+{
+    auto it = scopeIds.find(name);
+    if (it == scopeIds.end())
+        return {};
+
+    return lastStatistics[it->second];
+}
+
+const std::vector<std::string> &vk::GpuProfiler::getScopeNames() const
+{
+    return scopeNames;
+}
+
+void vk::GpuProfiler::clearStatistics()
+{
+    for (auto &history : histories)
+        history.clear();
+}
+
+const uint32_t vk::GpuProfiler::getScopeId(const std::string &name)
+{
+    auto it = scopeIds.find(name);
+    if (it != scopeIds.end())
+        return it->second;
+
+    const uint32_t id = static_cast<uint32_t>(scopeNames.size());
+
+    scopeIds.emplace(name, id);
+    scopeNames.push_back(name);
+    histories.emplace_back(HISTORY_SIZE);
+    lastStatistics.emplace_back();
+
+    return id;
+}
+
+const bool vk::GpuProfiler::collect(Frame &frame)
+{
+    if (frame.queryCount == 0)
+        return false;
+
+    // No WAIT_BIT: the frame's fence was waited on, results that are still not available are dropped
+    if (vkGetQueryPoolResults(device.getLogicalDevice(), frame.queryPool, 0, frame.queryCount,
+                              sizeof(uint64_t) * frame.queryCount, timestamps.data(), sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        return false;
+
+    frameTimes.assign(scopeNames.size(), 0.f);
+    measured.assign(scopeNames.size(), false);
+
+    for (const auto &scope : frame.scopes)
+    {
+        // Modulo 2^valid bits, so a counter that wrapped around between the two still gives the right difference
+        const uint64_t ticks = (timestamps[scope.firstQuery + 1] - timestamps[scope.firstQuery]) & timestampMask;
+
+        frameTimes[scope.scopeId] += static_cast<float>(static_cast<double>(ticks) * timestampPeriod * 1e-6);
+        measured[scope.scopeId] = true;
+    }
+
+    for (size_t id = 0; id < scopeNames.size(); ++id)
+    {
+        if (measured[id])
+            histories[id].add(frameTimes[id]);
+    }
+
+    collectPipelineStatistics(frame);
+
+    return true;
+}
+
+void vk::GpuProfiler::collectPipelineStatistics(Frame &frame)
+{
+    if (frame.statisticsQueryCount == 0)
+        return;
+
+    if (vkGetQueryPoolResults(device.getLogicalDevice(), frame.statisticsPool, 0, frame.statisticsQueryCount,
+                              sizeof(PipelineStatistics) * frame.statisticsQueryCount, statisticsResults.data(),
+                              sizeof(PipelineStatistics), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        return;
+
+    frameStatistics.assign(scopeNames.size(), PipelineStatistics{});
+    counted.assign(scopeNames.size(), false);
+
+    for (const auto &scope : frame.scopes)
+    {
+        if (scope.statisticsQuery == NO_STATISTICS_QUERY)
+            continue;
+
+        const PipelineStatistics &result = statisticsResults[scope.statisticsQuery];
+        PipelineStatistics &sum = frameStatistics[scope.scopeId];
+
+        sum.inputAssemblyVertices += result.inputAssemblyVertices;
+        sum.inputAssemblyPrimitives += result.inputAssemblyPrimitives;
+        sum.vertexShaderInvocations += result.vertexShaderInvocations;
+        sum.clippingInvocations += result.clippingInvocations;
+        sum.clippingPrimitives += result.clippingPrimitives;
+        sum.fragmentShaderInvocations += result.fragmentShaderInvocations;
+
+        counted[scope.scopeId] = true;
+    }
+
+    for (size_t id = 0; id < scopeNames.size(); ++id)
+    {
+        if (counted[id])
+            lastStatistics[id] = frameStatistics[id];
+    }
+}
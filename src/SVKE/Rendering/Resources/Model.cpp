@@ -1,5 +1,7 @@
 #include "SVKE/Rendering/Resources/Model.hpp"
 
+#include "SVKE/Core/Time/Profiler.hpp"
+
 vk::Model::Model(Device &device) : device(device), vertexCount(0), loaded(false), hasIndexBuffer(false)
 {
 }
@@ -25,6 +27,8 @@ void vk::Model::loadFromData(const VertexArray &vertices, const IndexArray &indi
 
 const bool vk::Model::loadFromFile(const std::string &path)
 {
+    SVKE_PROFILE_ZONE("vk::Model::loadFromFile");
+
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -36,9 +40,7 @@ const bool vk::Model::loadFromFile(const std::string &path)
         return false;
     }
 
-    VertexArray vertices;
-    IndexArray indices;
-    std::unordered_map<Vertex, Index> unique_vertices;
+    VertexArray stream;
 
     for (auto &shape : shapes)
     {
@@ -73,16 +75,14 @@ const bool vk::Model::loadFromFile(const std::string &path)
                         1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
             }
 
-            if (unique_vertices.find(v) == unique_vertices.end())
-            {
-                unique_vertices[v] = static_cast<Index>(vertices.size());
-                vertices.emplace_back(v);
-            }
-
-            indices.push_back(unique_vertices[v]);
+            stream.push_back(v);
         }
     }
 
+    VertexArray vertices;
+    IndexArray indices;
+    deduplicate(stream, vertices, indices);
+
     if (indices.size() > 0)
         loadFromData(vertices, indices);
     else
@@ -96,6 +96,26 @@ const bool vk::Model::loadFromFile(const std::string &path)
     return true;
 }
 
+void vk::Model::deduplicate(const VertexArray &stream, VertexArray &vertices, IndexArray &indices)
+{
+    vertices.clear();
+    indices.clear();
+    indices.reserve(stream.size());
+
+    std::unordered_map<Vertex, Index> unique_vertices;
+
+    for (const auto &v : stream)
+    {
+        if (unique_vertices.find(v) == unique_vertices.end())
+        {
+            unique_vertices[v] = static_cast<Index>(vertices.size());
+            vertices.emplace_back(v);
+        }
+
+        indices.push_back(unique_vertices[v]);
+    }
+}
+
 void vk::Model::bind(VkCommandBuffer &command_buffer)
 {
     assert(loaded == true && "CANNOT BIND UNINITIALIZED MODEL");
@@ -120,6 +140,11 @@ void vk::Model::draw(VkCommandBuffer &command_buffer)
         vkCmdDraw(command_buffer, vertexCount, 1, 0, 0);
 }
 
+const uint32_t vk::Model::getTriangleCount() const
+{
+    return (hasIndexBuffer ? indexCount : vertexCount) / 3;
+}
+
 std::unique_ptr<vk::Model> vk::Model::createCubeModel(Device &device, const glm::vec3 &offset)
 {
     VertexArray vertices = VertexArray{
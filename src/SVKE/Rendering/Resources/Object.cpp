@@ -2,16 +2,10 @@
 
 vk::Object::Object(const Color &color) : color(color)
 {
-    static objid_t GLOBAL_ID_COUNTER = 0;
-
-    id = GLOBAL_ID_COUNTER++;
 }
 
 vk::Object::Object(std::shared_ptr<Model> &model, const Color &color) : model(model), color(color)
 {
-    static objid_t GLOBAL_ID_COUNTER = 0;
-
-    id = GLOBAL_ID_COUNTER++;
 }
 
 void vk::Object::bind(VkCommandBuffer &command_buffer)
@@ -35,12 +29,12 @@ const std::shared_ptr<vk::TextureImage> &vk::Object::getTextureImage() const
     return textureImage;
 }
 
-vk::Mat4f vk::Object::transform()
+const vk::Mat4f &vk::Object::transform()
 {
     return transformComponent.mat4();
 }
 
-vk::Mat3f vk::Object::normalMatrix()
+const vk::Mat3f &vk::Object::normalMatrix()
 {
     return transformComponent.normalMatrix();
 }
@@ -50,24 +44,19 @@ const std::optional<vk::Object::PointLightComponent> &vk::Object::getPointLightC
     return pointLightComponent;
 }
 
-const vk::Object::objid_t &vk::Object::getId() const
-{
-    return id;
-}
-
 const vk::Vec3f &vk::Object::getTranslation() const
 {
-    return transformComponent.translation;
+    return transformComponent.getTranslation();
 }
 
 const vk::Vec3f &vk::Object::getScale() const
 {
-    return transformComponent.scale;
+    return transformComponent.getScale();
 }
 
 const vk::Vec3f &vk::Object::getRotation() const
 {
-    return transformComponent.rotation;
+    return transformComponent.getRotation();
 }
 
 const vk::Color &vk::Object::getColor() const
@@ -102,17 +91,17 @@ void vk::Object::setColor(const Color &color)
 
 void vk::Object::setTranslation(const Vec3f &translation)
 {
-    transformComponent.translation = translation;
+    transformComponent.setTranslation(translation);
 }
 
 void vk::Object::setScale(const Vec3f &scale)
 {
-    transformComponent.scale = scale;
+    transformComponent.setScale(scale);
 }
 
 void vk::Object::setRotation(const Vec3f &rotation)
 {
-    transformComponent.rotation = rotation;
+    transformComponent.setRotation(rotation);
 }
 
 void vk::Object::createPointLightComponent(const PointLightComponent &component)
@@ -130,58 +119,100 @@ vk::Object vk::Object::makePointLight(const float intensity, const float radius,
     return point_light;
 }
 
-vk::Mat4f vk::Object::TransformComponent::mat4()
+const vk::Vec3f &vk::Object::TransformComponent::getTranslation() const
 {
-    const float c3 = glm::cos(rotation.z);
-    const float s3 = glm::sin(rotation.z);
-    const float c2 = glm::cos(rotation.x);
-    const float s2 = glm::sin(rotation.x);
-    const float c1 = glm::cos(rotation.y);
-    const float s1 = glm::sin(rotation.y);
-    return Mat4f{{
-                     scale.x * (c1 * c3 + s1 * s2 * s3),
-                     scale.x * (c2 * s3),
-                     scale.x * (c1 * s2 * s3 - c3 * s1),
-                     0.0f,
-                 },
-                 {
-                     scale.y * (c3 * s1 * s2 - c1 * s3),
-                     scale.y * (c2 * c3),
-                     scale.y * (c1 * c3 * s2 + s1 * s3),
-                     0.0f,
-                 },
-                 {
-                     scale.z * (c2 * s1),
-                     scale.z * (-s2),
-                     scale.z * (c1 * c2),
-                     0.0f,
-                 },
-                 {translation.x, translation.y, translation.z, 1.0f}};
-}
-
-vk::Mat3f vk::Object::TransformComponent::normalMatrix()
+    return translation;
+}
+
+const vk::Vec3f &vk::Object::TransformComponent::getScale() const
+{
+    return scale;
+}
+
+const vk::Vec3f &vk::Object::TransformComponent::getRotation() const
+{
+    return rotation;
+}
+
+void vk::Object::TransformComponent::setTranslation(const Vec3f &translation)
+{
+    this->translation = translation;
+    dirty = true;
+    worldDirty = true;
+}
+
+void vk::Object::TransformComponent::setScale(const Vec3f &scale)
+{
+    this->scale = scale;
+    dirty = true;
+    worldDirty = true;
+}
+
+void vk::Object::TransformComponent::setRotation(const Vec3f &rotation)
+{
+    this->rotation = rotation;
+    dirty = true;
+    worldDirty = true;
+}
+
+const bool vk::Object::TransformComponent::isDirty() const
+{
+    return dirty;
+}
+
+const bool vk::Object::TransformComponent::isWorldDirty() const
+{
+    return worldDirty;
+}
+
+void vk::Object::TransformComponent::clearWorldDirty()
+{
+    worldDirty = false;
+}
+
+const vk::Mat4f &vk::Object::TransformComponent::mat4()
+{
+    if (dirty)
+        recompute();
+
+    return worldMatrix;
+}
+
+const vk::Mat3f &vk::Object::TransformComponent::normalMatrix()
 {
+    if (dirty)
+        recompute();
+
+    return normal;
+}
+
+void vk::Object::TransformComponent::setMatrices(const Mat4f &world_matrix, const Mat3f &normal_matrix)
+{
+    worldMatrix = world_matrix;
+    normal = normal_matrix;
+    dirty = false;
+}
+
+void vk::Object::TransformComponent::recompute()
+{
+    // Single sincos evaluation shared by the world and normal matrices
     const float c3 = glm::cos(rotation.z);
     const float s3 = glm::sin(rotation.z);
     const float c2 = glm::cos(rotation.x);
     const float s2 = glm::sin(rotation.x);
     const float c1 = glm::cos(rotation.y);
     const float s1 = glm::sin(rotation.y);
-    const Vec3f inverseScale = 1.0f / scale;
-
-    return Mat3f{{
-                     inverseScale.x * (c1 * c3 + s1 * s2 * s3),
-                     inverseScale.x * (c2 * s3),
-                     inverseScale.x * (c1 * s2 * s3 - c3 * s1),
-                 },
-                 {
-                     inverseScale.y * (c3 * s1 * s2 - c1 * s3),
-                     inverseScale.y * (c2 * c3),
-                     inverseScale.y * (c1 * c3 * s2 + s1 * s3),
-                 },
-                 {
-                     inverseScale.z * (c2 * s1),
-                     inverseScale.z * (-s2),
-                     inverseScale.z * (c1 * c2),
-                 }};
+
+    // Rotation basis columns (Ry * Rx * Rz)
+    const Vec3f u{(c1 * c3 + s1 * s2 * s3), (c2 * s3), (c1 * s2 * s3 - c3 * s1)};
+    const Vec3f v{(c3 * s1 * s2 - c1 * s3), (c2 * c3), (c1 * c3 * s2 + s1 * s3)};
+    const Vec3f w{(c2 * s1), (-s2), (c1 * c2)};
+
+    worldMatrix = Mat4f{Vec4f{scale.x * u, 0.f}, Vec4f{scale.y * v, 0.f}, Vec4f{scale.z * w, 0.f},
+                        Vec4f{translation, 1.f}};
+
+    const Vec3f inverse_scale = 1.f / scale;
+    normal = Mat3f{inverse_scale.x * u, inverse_scale.y * v, inverse_scale.z * w};
+
+    dirty = false;
 }
@@ -0,0 +1,150 @@
+#include "SVKE/Rendering/Scene/Scene.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+
+vk::Scene::objid_t vk::Scene::add(const Object &object)
+{
+    const objid_t id = transforms.insert(object.getTransformComponent());
+    graph.addNode(id);
+
+    if (object.getModel())
+    {
+        if (object.getTextureImage())
+            texturedMeshes.insert(id, {object.getModel(), object.getTextureImage()});
+        else
+            meshes.insert(id, {object.getModel()});
+    }
+
+    if (object.getPointLightComponent())
+        pointLights.insert(id, {object.getColor(), object.getPointLightComponent()->lightIntensity});
+
+    return id;
+}
+
+void vk::Scene::remove(const objid_t id)
+{
+    if (!transforms.remove(id))
+        return;
+
+    graph.removeNode(id);
+    meshes.remove(id);
+    texturedMeshes.remove(id);
+    pointLights.remove(id);
+}
+
+void vk::Scene::clear()
+{
+    transforms.clear();
+    graph.clear();
+    meshes.clear();
+    texturedMeshes.clear();
+    pointLights.clear();
+}
+
+const bool vk::Scene::contains(const objid_t id) const
+{
+    return transforms.contains(id);
+}
+
+const size_t vk::Scene::getObjectCount() const
+{
+    return transforms.size();
+}
+
+void vk::Scene::setParent(const objid_t id, const objid_t parent)
+{
+    graph.setParent(id, parent);
+}
+
+const vk::Scene::objid_t vk::Scene::getParent(const objid_t id) const
+{
+    return graph.getParent(id);
+}
+
+void vk::Scene::updateTransforms(const bool parallel)
+{
+    SVKE_PROFILE_ZONE("vk::Scene::updateTransforms");
+
+    updateLocalMatrices();
+    graph.update(transforms, parallel);
+}
+
+void vk::Scene::updateLocalMatrices()
+{
+    TransformScratch &scratch = transformScratch;
+    scratch.indices.clear();
+
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        if (transforms[i].isDirty())
+            scratch.indices.push_back(static_cast<uint32_t>(i));
+    }
+
+    const size_t count = scratch.indices.size();
+
+    if (count == 0)
+        return;
+
+    for (auto &component_array : scratch.soa)
+        component_array.resize(count);
+
+    scratch.worldMatrices.resize(count);
+    scratch.normalMatrices.resize(count);
+
+    // Gather into structure-of-arrays layout
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Object::TransformComponent &transform = transforms[scratch.indices[i]];
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            scratch.soa[axis][i] = transform.getTranslation()[axis];
+            scratch.soa[3 + axis][i] = transform.getRotation()[axis];
+            scratch.soa[6 + axis][i] = transform.getScale()[axis];
+        }
+    }
+
+    TransformBatch::Input input;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        input.translation[axis] = scratch.soa[axis].data();
+        input.rotation[axis] = scratch.soa[3 + axis].data();
+        input.scale[axis] = scratch.soa[6 + axis].data();
+    }
+    input.count = count;
+
+    TransformBatch::compute(input, scratch.worldMatrices.data(), scratch.normalMatrices.data());
+
+    for (size_t i = 0; i < count; ++i)
+        transforms[scratch.indices[i]].setMatrices(scratch.worldMatrices[i], scratch.normalMatrices[i]);
+}
+
+const vk::Mat4f &vk::Scene::getWorldMatrix(const objid_t id) const
+{
+    return graph.getWorldMatrix(id);
+}
+
+const vk::Mat3f &vk::Scene::getNormalMatrix(const objid_t id) const
+{
+    return graph.getNormalMatrix(id);
+}
+
+vk::SlotMap<vk::Object::TransformComponent> &vk::Scene::getTransforms()
+{
+    return transforms;
+}
+
+vk::ComponentArray<vk::Scene::MeshComponent> &vk::Scene::getMeshes()
+{
+    return meshes;
+}
+
+vk::ComponentArray<vk::Scene::TexturedMeshComponent> &vk::Scene::getTexturedMeshes()
+{
+    return texturedMeshes;
+}
+
+vk::ComponentArray<vk::Scene::PointLightComponent> &vk::Scene::getPointLights()
+{
+    return pointLights;
+}
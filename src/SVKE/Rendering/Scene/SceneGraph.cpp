@@ -0,0 +1,366 @@
+#include "SVKE/Rendering/Scene/SceneGraph.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+vk::SceneGraph::~SceneGraph()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    jobCondition.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void vk::SceneGraph::addNode(const objid_t id)
+{
+    assert(!contains(id) && "NODE ALREADY EXISTS FOR THIS ID");
+
+    const uint32_t slot = SlotHandle::index(id);
+
+    if (slot >= sparse.size())
+        sparse.resize(static_cast<size_t>(slot) + 1, NONE);
+
+    sparse[slot] = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({id, Object::INVALID_OBJ_ID, NONE, 0});
+    worldMatrices.emplace_back(1.f);
+    normalMatrices.emplace_back(1.f);
+    changed.push_back(1);
+
+    // New roots can simply be appended while the graph is flat; otherwise they belong before the first child
+    if (levelStarts.size() == 2)
+        levelStarts.back() = static_cast<uint32_t>(nodes.size());
+    else
+        orderDirty = true;
+}
+
+void vk::SceneGraph::removeNode(const objid_t id)
+{
+    if (!contains(id))
+        return;
+
+    for (auto &node : nodes)
+    {
+        if (node.parentId == id)
+            node.parentId = Object::INVALID_OBJ_ID;
+    }
+
+    const uint32_t position = positionOf(id);
+    const uint32_t last = static_cast<uint32_t>(nodes.size() - 1);
+
+    if (position != last)
+    {
+        nodes[position] = nodes[last];
+        worldMatrices[position] = worldMatrices[last];
+        normalMatrices[position] = normalMatrices[last];
+        changed[position] = changed[last];
+        sparse[SlotHandle::index(nodes[position].id)] = position;
+    }
+
+    nodes.pop_back();
+    worldMatrices.pop_back();
+    normalMatrices.pop_back();
+    changed.pop_back();
+    sparse[SlotHandle::index(id)] = NONE;
+
+    orderDirty = true;
+    forceUpdate = true;
+}
+
+void vk::SceneGraph::clear()
+{
+    nodes.clear();
+    worldMatrices.clear();
+    normalMatrices.clear();
+    changed.clear();
+    sparse.clear();
+    levelStarts.clear();
+
+    orderDirty = false;
+    forceUpdate = false;
+}
+
+void vk::SceneGraph::setParent(const objid_t id, const objid_t parent)
+{
+    assert(contains(id) && "NODE DOES NOT EXIST FOR THIS ID");
+
+    if (parent != Object::INVALID_OBJ_ID)
+    {
+        if (!contains(parent))
+            throw std::runtime_error("vk::SceneGraph::setParent: PARENT IS NOT IN THE SCENE GRAPH");
+
+        for (objid_t ancestor = parent; ancestor != Object::INVALID_OBJ_ID;
+             ancestor = nodes[positionOf(ancestor)].parentId)
+        {
+            if (ancestor == id)
+                throw std::runtime_error("vk::SceneGraph::setParent: PARENTING WOULD CREATE A CYCLE");
+        }
+    }
+
+    Node &node = nodes[positionOf(id)];
+
+    if (node.parentId == parent)
+        return;
+
+    node.parentId = parent;
+
+    orderDirty = true;
+    forceUpdate = true;
+}
+
+const vk::SceneGraph::objid_t vk::SceneGraph::getParent(const objid_t id) const
+{
+    assert(contains(id) && "NODE DOES NOT EXIST FOR THIS ID");
+
+    return nodes[positionOf(id)].parentId;
+}
+
+const bool vk::SceneGraph::contains(const objid_t id) const
+{
+    const uint32_t slot = SlotHandle::index(id);
+
+    return slot < sparse.size() && sparse[slot] != NONE && nodes[sparse[slot]].id == id;
+}
+
+const size_t vk::SceneGraph::getNodeCount() const
+{
+    return nodes.size();
+}
+
+const size_t vk::SceneGraph::getDepthCount()
+{
+    if (orderDirty || levelStarts.empty())
+        rebuildOrder();
+
+    return levelStarts.size() - 1;
+}
+
+void vk::SceneGraph::update(SlotMap<Object::TransformComponent> &transforms, const bool parallel)
+{
+    if (nodes.empty())
+        return;
+
+    if (orderDirty || levelStarts.empty())
+        rebuildOrder();
+
+    for (size_t level = 0; level + 1 < levelStarts.size(); ++level)
+    {
+        const uint32_t begin = levelStarts[level];
+        const uint32_t end = levelStarts[level + 1];
+
+        if (parallel && end - begin >= PARALLEL_MIN_LEVEL_SIZE)
+            updateLevelParallel(transforms, begin, end);
+        else
+            updateRange(transforms, begin, end);
+    }
+
+    forceUpdate = false;
+}
+
+const vk::Mat4f &vk::SceneGraph::getWorldMatrix(const objid_t id) const
+{
+    assert(contains(id) && "NODE DOES NOT EXIST FOR THIS ID");
+
+    return worldMatrices[positionOf(id)];
+}
+
+const vk::Mat3f &vk::SceneGraph::getNormalMatrix(const objid_t id) const
+{
+    assert(contains(id) && "NODE DOES NOT EXIST FOR THIS ID");
+
+    return normalMatrices[positionOf(id)];
+}
+
+const uint32_t vk::SceneGraph::positionOf(const objid_t id) const
+{
+    return sparse[SlotHandle::index(id)];
+}
+
+void vk::SceneGraph::rebuildOrder()
+{
+    const uint32_t count = static_cast<uint32_t>(nodes.size());
+
+    // Depths are resolved by walking up to the nearest node with a known depth
+    std::vector<uint32_t> depths(count, NONE);
+    std::vector<uint32_t> chain;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t current = i;
+
+        while (depths[current] == NONE)
+        {
+            const objid_t parent_id = nodes[current].parentId;
+
+            if (parent_id == Object::INVALID_OBJ_ID)
+            {
+                depths[current] = 0;
+                break;
+            }
+
+            chain.push_back(current);
+            current = positionOf(parent_id);
+        }
+
+        uint32_t depth = depths[current];
+        while (!chain.empty())
+        {
+            depths[chain.back()] = ++depth;
+            chain.pop_back();
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+        nodes[i].depth = depths[i];
+
+    // Stable, so siblings keep their relative order between rebuilds
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(),
+                     [this](const uint32_t a, const uint32_t b) { return nodes[a].depth < nodes[b].depth; });
+
+    std::vector<Node> sorted_nodes(count);
+    std::vector<Mat4f> sorted_world(count);
+    std::vector<Mat3f> sorted_normal(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sorted_nodes[i] = nodes[order[i]];
+        sorted_world[i] = worldMatrices[order[i]];
+        sorted_normal[i] = normalMatrices[order[i]];
+    }
+
+    nodes = std::move(sorted_nodes);
+    worldMatrices = std::move(sorted_world);
+    normalMatrices = std::move(sorted_normal);
+
+    for (uint32_t i = 0; i < count; ++i)
+        sparse[SlotHandle::index(nodes[i].id)] = i;
+
+    levelStarts.clear();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        nodes[i].parent = nodes[i].parentId == Object::INVALID_OBJ_ID ? NONE : positionOf(nodes[i].parentId);
+
+        if (i == 0 || nodes[i].depth != nodes[i - 1].depth)
+            levelStarts.push_back(i);
+    }
+    levelStarts.push_back(count);
+
+    orderDirty = false;
+}
+
+void vk::SceneGraph::updateRange(SlotMap<Object::TransformComponent> &transforms, const uint32_t begin,
+                                 const uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const Node &node = nodes[i];
+        Object::TransformComponent &transform = transforms.get(node.id);
+
+        const bool parent_changed = node.parent != NONE && changed[node.parent];
+        const bool is_changed = forceUpdate || transform.isWorldDirty() || parent_changed;
+
+        changed[i] = is_changed;
+
+        if (!is_changed)
+            continue;
+
+        transform.clearWorldDirty();
+
+        if (node.parent == NONE)
+        {
+            worldMatrices[i] = transform.mat4();
+            normalMatrices[i] = transform.normalMatrix();
+        }
+        else
+        {
+            // The inverse transpose of a product is the product of the inverse transposes
+            worldMatrices[i] = worldMatrices[node.parent] * transform.mat4();
+            normalMatrices[i] = normalMatrices[node.parent] * transform.normalMatrix();
+        }
+    }
+}
+
+void vk::SceneGraph::updateLevelParallel(SlotMap<Object::TransformComponent> &transforms, const uint32_t begin,
+                                         const uint32_t end)
+{
+    if (workers.empty())
+    {
+        const size_t worker_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+        if (worker_count == 0)
+        {
+            updateRange(transforms, begin, end);
+            return;
+        }
+
+        workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; ++i)
+            workers.emplace_back(&SceneGraph::workerLoop, this);
+    }
+
+    // Nodes on one level only read their parents' results from the previous level
+    const uint32_t thread_count = static_cast<uint32_t>(workers.size() + 1);
+    const uint32_t chunk_size = (end - begin + thread_count - 1) / thread_count;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    job.transforms = &transforms;
+    job.begin = begin;
+    job.end = end;
+    job.chunkSize = chunk_size;
+    job.chunkCount = (end - begin + chunk_size - 1) / chunk_size;
+    job.nextChunk = 0;
+    job.doneChunks = 0;
+
+    jobCondition.notify_all();
+
+    // The updating thread works on the level too instead of only waiting for it
+    runChunks(lock);
+
+    doneCondition.wait(lock, [this]() { return job.doneChunks == job.chunkCount; });
+}
+
+void vk::SceneGraph::runChunks(std::unique_lock<std::mutex> &lock)
+{
+    while (job.nextChunk < job.chunkCount)
+    {
+        const uint32_t chunk_begin = job.begin + job.nextChunk++ * job.chunkSize;
+        const uint32_t chunk_end = std::min(job.end, chunk_begin + job.chunkSize);
+        auto &transforms = *job.transforms;
+
+        lock.unlock();
+        updateRange(transforms, chunk_begin, chunk_end);
+        lock.lock();
+
+        if (++job.doneChunks == job.chunkCount)
+            doneCondition.notify_one();
+    }
+}
+
+void vk::SceneGraph::workerLoop()
+{
+    SVKE_PROFILE_THREAD("Scene graph worker");
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        jobCondition.wait(lock, [this]() { return stopping || job.nextChunk < job.chunkCount; });
+
+        if (stopping)
+            return;
+
+        runChunks(lock);
+    }
+}
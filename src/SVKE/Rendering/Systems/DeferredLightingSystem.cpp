@@ -0,0 +1,154 @@
+#include "SVKE/Rendering/Systems/DeferredLightingSystem.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+
+vk::DeferredLightingSystem::DeferredLightingSystem(Device &device, Renderer &renderer,
+                                                   PipelineManager &pipeline_manager,
+                                                   DescriptorSetLayout &global_set_layout)
+    : device(device), pipelineManager(pipeline_manager), renderer(renderer), pipelineLayout(VK_NULL_HANDLE),
+      inputSetsGeneration(0)
+{
+    assert(renderer.getRenderPath() == Swapchain::RenderPath::Deferred && "RENDERER DOES NOT USE THE DEFERRED PATH");
+
+    loadShaders();
+    createInputDescriptors();
+    writeInputDescriptorSets();
+    createPipelineLayout(global_set_layout);
+    createPipeline(pipeline_manager);
+}
+
+vk::DeferredLightingSystem::~DeferredLightingSystem()
+{
+    // The layout must outlive a compilation that is still running
+    if (pipeline.isValid())
+        pipeline.wait();
+
+    pipelineManager.releasePipelineLayout(pipelineLayout);
+    vkDestroyPipelineLayout(device.getLogicalDevice(), pipelineLayout, nullptr);
+}
+
+void vk::DeferredLightingSystem::render(const FrameInfo &frame_info)
+{
+    SVKE_PROFILE_ZONE("vk::DeferredLightingSystem::render");
+
+    if (!pipeline.isReady())
+        return;
+
+    // The swapchain was recreated since the sets were written, the device is idle at this point
+    if (inputSetsGeneration != renderer.getSwapchainGeneration())
+        writeInputDescriptorSets();
+
+    pipeline.get().bind(frame_info.commandBuffer);
+
+    std::array<VkDescriptorSet, 2> descriptor_sets{frame_info.globalDescriptorSet,
+                                                   inputSets[renderer.getCurrentImageIndex()]};
+
+    vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0,
+                            static_cast<uint32_t>(descriptor_sets.size()), descriptor_sets.data(), 0, nullptr);
+
+    vkCmdDraw(frame_info.commandBuffer, 3, 1, 0, 0);
+
+    // One call binds both sets
+    ++frame_info.stats.pipelineBinds;
+    ++frame_info.stats.descriptorSetBinds;
+    frame_info.stats.addDraw(1, 1);
+}
+
+void vk::DeferredLightingSystem::loadShaders()
+{
+    vertShader = std::make_shared<Shader>(device, "assets/shaders/fullscreen.vert.spv");
+    fragShader = std::make_shared<Shader>(device, "assets/shaders/deferred_lighting.frag.spv");
+}
+
+void vk::DeferredLightingSystem::createInputDescriptors()
+{
+    inputSetLayout = DescriptorSetLayout::Builder(device)
+                         .addBinding(0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+                         .addBinding(1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+                         .addBinding(2, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+                         .build();
+
+    inputPool = DescriptorPool::Builder(device)
+                    .setMaxSets(MAX_SWAPCHAIN_IMAGES)
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 3 * MAX_SWAPCHAIN_IMAGES)
+                    .build();
+}
+
+void vk::DeferredLightingSystem::writeInputDescriptorSets()
+{
+    Swapchain &swapchain = renderer.getSwapchain();
+    const size_t image_count = swapchain.getImageCount();
+
+    assert(image_count <= MAX_SWAPCHAIN_IMAGES && "TOO MANY SWAPCHAIN IMAGES FOR THE INPUT ATTACHMENT POOL");
+
+    inputPool->resetPool();
+    inputSets.assign(image_count, VK_NULL_HANDLE);
+
+    VkDescriptorImageInfo albedo_info = {};
+    albedo_info.imageView = swapchain.getAlbedoImageView();
+    albedo_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo normal_info = {};
+    normal_info.imageView = swapchain.getNormalImageView();
+    normal_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    for (size_t i = 0; i < image_count; ++i)
+    {
+        VkDescriptorImageInfo depth_info = {};
+        depth_info.imageView = swapchain.getDepthImageView(static_cast<int>(i));
+        depth_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+        if (!DescriptorWriter(*inputSetLayout, *inputPool)
+                 .writeImage(0, albedo_info)
+                 .writeImage(1, normal_info)
+                 .writeImage(2, depth_info)
+                 .build(inputSets[i]))
+            throw std::runtime_error(
+                "vk::DeferredLightingSystem::writeInputDescriptorSets: FAILED TO ALLOCATE INPUT ATTACHMENT SET");
+    }
+
+    inputSetsGeneration = renderer.getSwapchainGeneration();
+}
+
+void vk::DeferredLightingSystem::createPipelineLayout(DescriptorSetLayout &global_set_layout)
+{
+    std::vector<VkDescriptorSetLayout> set_layouts{global_set_layout.getDescriptorSetLayout(),
+                                                   inputSetLayout->getDescriptorSetLayout()};
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info = {};
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+    pipeline_layout_info.pSetLayouts = set_layouts.data();
+    pipeline_layout_info.pushConstantRangeCount = 0;
+    pipeline_layout_info.pPushConstantRanges = nullptr;
+
+    if (vkCreatePipelineLayout(device.getLogicalDevice(), &pipeline_layout_info, nullptr, &pipelineLayout) !=
+        VK_SUCCESS)
+        throw std::runtime_error("vk::DeferredLightingSystem::createPipelineLayout: FAILED TO CREATE PIPELINE LAYOUT");
+}
+
+void vk::DeferredLightingSystem::createPipeline(PipelineManager &pipeline_manager)
+{
+    assert(pipelineLayout != VK_NULL_HANDLE && "CANNOT CREATE PIPELINE BEFORE PIPELINE LAYOUT");
+
+    auto pipeline_config = std::make_unique<Pipeline::Config>();
+    Pipeline::defaultPipelineConfig(*pipeline_config);
+
+    pipeline_config->attributeDescriptions.clear();
+    pipeline_config->bindingDescriptions.clear();
+    renderer.setPipelineTarget(*pipeline_config);
+    pipeline_config->subpass = Swapchain::LIGHTING_SUBPASS;
+    pipeline_config->pipelineLayout = pipelineLayout;
+    pipeline_config->multisampleInfo.rasterizationSamples = renderer.getSampleCount();
+
+    // Depth is only read, through the input attachment
+    pipeline_config->depthStencilInfo.depthTestEnable = VK_FALSE;
+    pipeline_config->depthStencilInfo.depthWriteEnable = VK_FALSE;
+
+    // Same lighting as the forward path, see clustered_lighting.glsl
+    MeshShaderVariant variant = {};
+    variant.apply(pipeline_config->fragSpecialization);
+
+    // Compiled on a worker thread, render() skips drawing until it is ready
+    pipeline = pipeline_manager.request(vertShader, fragShader, std::move(pipeline_config));
+}
@@ -1,127 +1,199 @@
 #include "SVKE/Rendering/Systems/PointLightSystem.hpp"
 
-vk::PointLightSystem::PointLightSystem(Device &device, Renderer &renderer, DescriptorSetLayout &global_set_layout)
-    : device(device), pipelineLayout(VK_NULL_HANDLE)
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+
+vk::PointLightSystem::PointLightSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
+                                       DescriptorSetLayout &global_set_layout)
+    : device(device), pipelineManager(pipeline_manager), pipelineLayout(VK_NULL_HANDLE),
+      frameInstances(renderer.getFramesInFlight())
 {
     loadShaders();
     createPipelineLayout(global_set_layout);
-    createPipeline(renderer.getRenderPass());
+    createPipeline(renderer, pipeline_manager);
 }
 
 vk::PointLightSystem::~PointLightSystem()
 {
+    // The layout must outlive a compilation that is still running
+    if (pipeline.isValid())
+        pipeline.wait();
+
+    pipelineManager.releasePipelineLayout(pipelineLayout);
     vkDestroyPipelineLayout(device.getLogicalDevice(), pipelineLayout, nullptr);
 }
 
-void vk::PointLightSystem::update(const FrameInfo &frame_info, GlobalUBO &ubo)
+void vk::PointLightSystem::animate(Scene &scene, const float dt)
 {
-    auto rotate_light = Matrix::rotate(Matrix::identityMat4f(), frame_info.dt, {0.f, -1.f, 0.f});
+    SVKE_PROFILE_ZONE("vk::PointLightSystem::animate");
 
-    int light_index = 0;
+    auto rotate_light = Matrix::rotate(Matrix::identityMat4f(), dt, {0.f, -1.f, 0.f});
 
-    for (auto &[_, object] : frame_info.objects)
+    auto &point_lights = scene.getPointLights();
+    auto &transforms = scene.getTransforms();
+
+    for (size_t i = 0; i < point_lights.size(); ++i)
     {
-        if (!object.getPointLightComponent())
-            continue;
+        auto &transform = transforms.get(point_lights.getId(i));
+        transform.setTranslation(Vec3f{rotate_light * Vec4f{transform.getTranslation(), 1.0}});
+    }
+}
 
-        assert(light_index < MAX_LIGHTS && "POINT LIGHTS EXCEEDED MAXIMUM SPECIFIED");
+void vk::PointLightSystem::update(const FrameInfo &frame_info, LightClusters &light_clusters)
+{
+    SVKE_PROFILE_ZONE("vk::PointLightSystem::update");
 
-        // Update
-        object.setTranslation(Vec3f{rotate_light * Vec4f{object.getTranslation(), 1.0}});
+    auto &point_lights = frame_info.scene.getPointLights();
 
-        // Copy data to UBO
-        ubo.pointLights[light_index].position = object.getTranslation();
-        ubo.pointLights[light_index].color =
-            Vec4f{object.getColor().toVec3(), object.getPointLightComponent()->lightIntensity};
+    light_clusters.beginLights();
 
-        ++light_index;
+    for (size_t i = 0; i < point_lights.size(); ++i)
+    {
+        light_clusters.addLight(Vec3f{frame_info.scene.getWorldMatrix(point_lights.getId(i))[3]},
+                                point_lights[i].color, point_lights[i].lightIntensity);
     }
-
-    ubo.numLights = light_index;
 }
 
 void vk::PointLightSystem::render(const FrameInfo &frame_info)
 {
-    // Sort lights
-    std::map<float, Object::objid_t> sorted;
+    SVKE_PROFILE_ZONE("vk::PointLightSystem::render");
 
-    for (auto &[_, object] : frame_info.objects)
+    if (!pipeline.isReady())
+        return;
+
+    auto &point_lights = frame_info.scene.getPointLights();
+    auto &transforms = frame_info.scene.getTransforms();
+
+    if (point_lights.size() == 0)
+        return;
+
+    lightPositions.clear();
+
+    for (size_t i = 0; i < point_lights.size(); ++i)
+        lightPositions.push_back(Vec3f{frame_info.scene.getWorldMatrix(point_lights.getId(i))[3]});
+
+    // Equally distant lights keep their dense order
+    sortBackToFront(frame_info.camera.getPosition(), lightPositions, sortEntries, sortScratch);
+
+    instances.clear();
+
+    for (const auto &entry : sortEntries)
     {
-        if (!object.getPointLightComponent())
-            continue;
+        const auto id = point_lights.getId(entry.index);
+        auto &light = point_lights[entry.index];
+
+        LightInstance instance = {};
+        instance.position = Vec4f{lightPositions[entry.index], transforms.get(id).getScale().x};
+        instance.color = Vec4f{light.color.toVec3(), light.lightIntensity};
 
-        // calculate distance
-        Vec3f offset = frame_info.camera.getPosition() - object.getTranslation();
-        float dis_squared = Vector::dot(offset, offset);
-        sorted[dis_squared] = object.getId();
+        instances.push_back(instance);
     }
 
-    pipeline->bind(frame_info.commandBuffer);
+    FrameInstances &frame = frameInstances[frame_info.frameIndex];
+    reserveInstances(frame, instances.size());
+    frame.buffer->write(instances.data(), sizeof(LightInstance) * instances.size());
+    frame.buffer->flush(sizeof(LightInstance) * instances.size());
+    frame_info.stats.bytesUploaded += sizeof(LightInstance) * instances.size();
+
+    pipeline.get().bind(frame_info.commandBuffer);
 
     vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
                             &frame_info.globalDescriptorSet, 0, nullptr);
 
-    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
-    {
-        auto &object = frame_info.objects.at(it->second);
+    VkBuffer buffers[] = {frame.buffer->getBuffer()};
+    VkDeviceSize offsets[] = {0};
 
-        PointLightPushConstant push = {};
-        push.position = object.getTranslation();
-        push.color = Vec4f{object.getColor().toVec3(), object.getPointLightComponent()->lightIntensity};
-        push.radius = object.getScale().x;
+    vkCmdBindVertexBuffers(frame_info.commandBuffer, 0, 1, buffers, offsets);
 
-        vkCmdPushConstants(frame_info.commandBuffer, pipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PointLightPushConstant),
-                           &push);
+    vkCmdDraw(frame_info.commandBuffer, 6, static_cast<uint32_t>(instances.size()), 0, 0);
 
-        vkCmdDraw(frame_info.commandBuffer, 6, 1, 0, 0);
+    // Each light is a quad
+    ++frame_info.stats.pipelineBinds;
+    ++frame_info.stats.descriptorSetBinds;
+    frame_info.stats.addDraw(static_cast<uint32_t>(instances.size()), 2);
+}
+
+void vk::PointLightSystem::computeSortEntries(const Vec3f &camera_position, const std::vector<Vec3f> &positions,
+                                              std::vector<SortEntry> &entries)
+{
+    entries.clear();
+
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const Vec3f offset = camera_position - positions[i];
+        entries.push_back({~radixKey(Vector::dot(offset, offset)), static_cast<uint32_t>(i)});
     }
 }
 
+void vk::PointLightSystem::sortBackToFront(const Vec3f &camera_position, const std::vector<Vec3f> &positions,
+                                           std::vector<SortEntry> &entries, std::vector<SortEntry> &scratch)
+{
+    computeSortEntries(camera_position, positions, entries);
+    radixSort(entries, scratch, [](const SortEntry &entry) { return entry.key; });
+}
+
 void vk::PointLightSystem::loadShaders()
 {
-    vertShader = std::make_unique<Shader>(device, "assets/shaders/point_light_system.vert.spv");
-    fragShader = std::make_unique<Shader>(device, "assets/shaders/point_light_system.frag.spv");
+    vertShader = std::make_shared<Shader>(device, "assets/shaders/point_light_system.vert.spv");
+    fragShader = std::make_shared<Shader>(device, "assets/shaders/point_light_system.frag.spv");
 }
 
 void vk::PointLightSystem::createPipelineLayout(DescriptorSetLayout &global_set_layout)
 {
-    VkPushConstantRange push_constant_range = {};
-    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    push_constant_range.offset = 0;
-    push_constant_range.size = sizeof(PointLightPushConstant);
-
     std::vector<VkDescriptorSetLayout> global_set_layouts{global_set_layout.getDescriptorSetLayout()};
 
     VkPipelineLayoutCreateInfo pipeline_layout_info = {};
     pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(global_set_layouts.size());
     pipeline_layout_info.pSetLayouts = global_set_layouts.data();
-    pipeline_layout_info.pushConstantRangeCount = 1;
-    pipeline_layout_info.pPushConstantRanges = &push_constant_range;
+    pipeline_layout_info.pushConstantRangeCount = 0;
+    pipeline_layout_info.pPushConstantRanges = nullptr;
 
     if (vkCreatePipelineLayout(device.getLogicalDevice(), &pipeline_layout_info, nullptr, &pipelineLayout) !=
         VK_SUCCESS)
         throw std::runtime_error("vk::PointLightSystem::createPipelineLayout: FAILED TO CREATE PIPELINE LAYOUT");
 }
 
-void vk::PointLightSystem::createPipeline(VkRenderPass render_pass)
+void vk::PointLightSystem::createPipeline(Renderer &renderer, PipelineManager &pipeline_manager)
 {
     assert(pipelineLayout != VK_NULL_HANDLE && "CANNOT CREATE PIPELINE BEFORE PIPELINE LAYOUT");
 
-    Pipeline::Config pipeline_config = {};
-    Pipeline::defaultPipelineConfig(pipeline_config);
-    Pipeline::enableAlphaBlending(pipeline_config);
+    auto pipeline_config = std::make_unique<Pipeline::Config>();
+    Pipeline::defaultPipelineConfig(*pipeline_config);
+    Pipeline::enableAlphaBlending(*pipeline_config);
 
-    pipeline_config.attributeDescriptions.clear();
-    pipeline_config.bindingDescriptions.clear();
-    pipeline_config.renderPass = render_pass;
-    pipeline_config.pipelineLayout = pipelineLayout;
-    pipeline_config.multisampleInfo.rasterizationSamples = device.getCurrentMsaaSamples();
+    pipeline_config->attributeDescriptions = LightInstance::getAttributeDescriptions();
+    pipeline_config->bindingDescriptions = LightInstance::getBindingDescriptions();
+    renderer.setPipelineTarget(*pipeline_config);
+    pipeline_config->pipelineLayout = pipelineLayout;
+    pipeline_config->multisampleInfo.rasterizationSamples = renderer.getSampleCount();
 
     // Optional: Shader antialiasing, smooths inner parts of shapes. Might cost some performance
-    pipeline_config.multisampleInfo.sampleShadingEnable = VK_TRUE;
-    pipeline_config.multisampleInfo.minSampleShading = .2f;
+    pipeline_config->multisampleInfo.sampleShadingEnable = VK_TRUE;
+    pipeline_config->multisampleInfo.minSampleShading = .2f;
+
+    // Drawn after the lighting subpass resolved the scene, against its read-only depth
+    if (renderer.getRenderPath() == Swapchain::RenderPath::Deferred)
+    {
+        pipeline_config->subpass = Swapchain::LIGHTING_SUBPASS;
+        pipeline_config->depthStencilInfo.depthWriteEnable = VK_FALSE;
+    }
+
+    // Compiled on a worker thread, render() skips drawing until it is ready
+    pipeline = pipeline_manager.request(vertShader, fragShader, std::move(pipeline_config));
+}
 
-    pipeline = std::make_unique<Pipeline>(device, *vertShader, *fragShader, pipeline_config);
+void vk::PointLightSystem::reserveInstances(FrameInstances &frame, const size_t count)
+{
+    if (count <= frame.capacity)
+        return;
+
+    frame.capacity = std::max(count, frame.capacity * 2);
+    frame.buffer = std::make_unique<Buffer>(device, sizeof(LightInstance) * frame.capacity,
+                                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            VMA_MEMORY_USAGE_AUTO,
+                                            VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                                                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    frame.buffer->map();
 }
@@ -1,47 +1,72 @@
 #include "SVKE/Rendering/Systems/RenderSystem.hpp"
 
-vk::RenderSystem::RenderSystem(Device &device, Renderer &renderer, DescriptorSetLayout &global_set_layout)
-    : device(device), pipelineLayout(VK_NULL_HANDLE)
+#include "SVKE/Core/Time/Profiler.hpp"
+
+vk::RenderSystem::RenderSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
+                               DescriptorSetLayout &global_set_layout)
+    : device(device), pipelineManager(pipeline_manager), pipelineLayout(VK_NULL_HANDLE)
 {
-    loadShaders();
+    loadShaders(renderer.getRenderPath());
     createPipelineLayout(global_set_layout);
-    createPipeline(renderer.getRenderPass());
+    createPipeline(renderer, pipeline_manager);
 }
 
 vk::RenderSystem::~RenderSystem()
 {
+    // The layout must outlive a compilation that is still running
+    if (pipeline.isValid())
+        pipeline.wait();
+
+    pipelineManager.releasePipelineLayout(pipelineLayout);
     vkDestroyPipelineLayout(device.getLogicalDevice(), pipelineLayout, nullptr);
 }
 
 void vk::RenderSystem::render(const FrameInfo &frame_info)
 {
-    pipeline->bind(frame_info.commandBuffer);
+    SVKE_PROFILE_ZONE("vk::RenderSystem::render");
+
+    if (!pipeline.isReady())
+        return;
+
+    pipeline.get().bind(frame_info.commandBuffer);
 
     vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
                             &frame_info.globalDescriptorSet, 0, nullptr);
 
-    for (auto &[_, object] : frame_info.objects)
+    ++frame_info.stats.pipelineBinds;
+    ++frame_info.stats.descriptorSetBinds;
+
+    auto &meshes = frame_info.scene.getMeshes();
+
+    for (size_t i = 0; i < meshes.size(); ++i)
     {
-        if (object.getTextureImage())
-            continue;
+        const auto id = meshes.getId(i);
 
         PushConstantData push = {};
-        push.modelMatrix = object.transform();
-        push.normalMatrix = object.normalMatrix();
+        push.modelMatrix = frame_info.scene.getWorldMatrix(id);
+        push.normalMatrix = frame_info.scene.getNormalMatrix(id);
 
         vkCmdPushConstants(frame_info.commandBuffer, pipelineLayout,
                            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData),
                            &push);
 
-        object.bind(frame_info.commandBuffer);
-        object.draw(frame_info.commandBuffer);
+        meshes[i].model->bind(frame_info.commandBuffer);
+        meshes[i].model->draw(frame_info.commandBuffer);
+
+        ++frame_info.stats.pushConstantUpdates;
+        frame_info.stats.addDraw(1, meshes[i].model->getTriangleCount());
     }
 }
 
-void vk::RenderSystem::loadShaders()
+void vk::RenderSystem::loadShaders(const Swapchain::RenderPath &render_path)
 {
-    vertShader = std::make_unique<Shader>(device, "assets/shaders/render_system.vert.spv");
-    fragShader = std::make_unique<Shader>(device, "assets/shaders/render_system.frag.spv");
+    vertShader = std::make_shared<Shader>(device, "assets/shaders/mesh.vert.spv");
+
+    // The deferred path only writes the G-buffer here, shading happens in DeferredLightingSystem
+    if (render_path == Swapchain::RenderPath::Deferred)
+        fragShader = std::make_shared<Shader>(device, "assets/shaders/mesh_gbuffer.frag.spv");
+    else
+        fragShader = std::make_shared<Shader>(device, "assets/shaders/mesh.frag.spv");
 }
 
 void vk::RenderSystem::createPipelineLayout(DescriptorSetLayout &global_set_layout)
@@ -65,22 +90,33 @@ void vk::RenderSystem::createPipelineLayout(DescriptorSetLayout &global_set_layo
         throw std::runtime_error("vk::RenderSystem::createPipelineLayout: FAILED TO CREATE PIPELINE LAYOUT");
 }
 
-void vk::RenderSystem::createPipeline(VkRenderPass render_pass)
+void vk::RenderSystem::createPipeline(Renderer &renderer, PipelineManager &pipeline_manager)
 {
     assert(pipelineLayout != VK_NULL_HANDLE && "CANNOT CREATE PIPELINE BEFORE PIPELINE LAYOUT");
 
-    Pipeline::Config pipeline_config = {};
-    Pipeline::defaultPipelineConfig(pipeline_config);
+    auto pipeline_config = std::make_unique<Pipeline::Config>();
+    Pipeline::defaultPipelineConfig(*pipeline_config);
 
-    pipeline_config.renderPass = render_pass;
-    pipeline_config.pipelineLayout = pipelineLayout;
-    pipeline_config.multisampleInfo.rasterizationSamples = device.getCurrentMsaaSamples();
-    pipeline_config.rasterizationInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-    pipeline_config.rasterizationInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    renderer.setPipelineTarget(*pipeline_config);
+    pipeline_config->pipelineLayout = pipelineLayout;
+    pipeline_config->multisampleInfo.rasterizationSamples = renderer.getSampleCount();
+    pipeline_config->rasterizationInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+    pipeline_config->rasterizationInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
     // Optional: Shader antialiasing, smooths inner parts of shapes. Might cost some performance
-    pipeline_config.multisampleInfo.sampleShadingEnable = VK_TRUE;
-    pipeline_config.multisampleInfo.minSampleShading = .2f;
+    pipeline_config->multisampleInfo.sampleShadingEnable = VK_TRUE;
+    pipeline_config->multisampleInfo.minSampleShading = .2f;
+
+    if (renderer.getRenderPath() == Swapchain::RenderPath::Deferred)
+    {
+        // Albedo and normal targets
+        pipeline_config->subpass = Swapchain::GEOMETRY_SUBPASS;
+        Pipeline::setColorAttachmentCount(*pipeline_config, 2);
+    }
+
+    MeshShaderVariant variant = {};
+    variant.apply(pipeline_config->fragSpecialization);
 
-    pipeline = std::make_unique<Pipeline>(device, *vertShader, *fragShader, pipeline_config);
+    // Compiled on a worker thread, render() skips drawing until it is ready
+    pipeline = pipeline_manager.request(vertShader, fragShader, std::move(pipeline_config));
 }
@@ -1,10 +1,60 @@
 #include "SVKE/Rendering/Systems/Renderer.hpp"
 
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+void transitionImage(VkCommandBuffer command_buffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout from,
+                     VkImageLayout to, VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+                     VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+{
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = from;
+    barrier.newLayout = to;
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = aspect;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+const bool hasStencilComponent(const VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+}
+} // namespace
+
 vk::Renderer::Renderer(Device &device, Window &window, const Swapchain::PresentMode &preferred_present_mode,
-                       const Color &clear_color)
-    : device(device), window(window), preferredPresentMode(preferred_present_mode), clearColor(clear_color),
-      currentImageIndex(0), currentFrameIndex(0), frameInProgress(false)
+                       const Color &clear_color, const Swapchain::RenderPath &render_path,
+                       const Swapchain::RenderingMode &rendering_mode, const uint32_t frames_in_flight,
+                       const uint32_t preferred_image_count)
+    : device(device), window(window), preferredPresentMode(preferred_present_mode), renderPath(render_path),
+      renderingMode(rendering_mode), clearColor(clear_color), framesInFlight(frames_in_flight),
+      preferredImageCount(preferred_image_count), lowLatencyMode(false), dynamicResolutionEnabled(false),
+      renderScale(1.f), gpuProfiler(device, frames_in_flight), gpuFrameTime(0.f), gpuFrameTimeNew(false),
+      nextFrameStats(0), frameNumber(0), pipelineManager(nullptr), currentImageIndex(0), lastRenderedImage(-1),
+      swapchainGeneration(0), currentFrameIndex(0), frameInProgress(false)
 {
+    if (renderingMode == Swapchain::RenderingMode::Dynamic &&
+        (!device.supportsDynamicRendering() || renderPath == Swapchain::RenderPath::Deferred))
+    {
+#ifndef NDEBUG
+        std::cout << "DYNAMIC RENDERING NOT AVAILABLE, USING RENDER PASSES" << std::endl;
+#endif
+        renderingMode = Swapchain::RenderingMode::RenderPass;
+    }
+
     recreateSwapchain();
     createCommandBuffers();
 }
@@ -14,10 +64,26 @@ vk::Renderer::~Renderer()
     freeCommandBuffers();
 }
 
+void vk::Renderer::waitForNextFrame()
+{
+    SVKE_PROFILE_ZONE("vk::Renderer::waitForNextFrame");
+
+    assert(!frameInProgress && "CANNOT WAIT FOR THE NEXT FRAME WHILE A FRAME IS IN PROGRESS");
+
+    if (lowLatencyMode && !swapchain->waitForLastPresent(PRESENT_WAIT_TIMEOUT))
+        swapchain->waitForLastSubmission();
+
+    frameLimiter.wait();
+}
+
 VkCommandBuffer vk::Renderer::beginFrame()
 {
+    SVKE_PROFILE_ZONE("vk::Renderer::beginFrame");
+
     assert(!frameInProgress && "CANNOT BEGIN FRAME WHEN ANOTHER FRAME IS IN PROGRESS");
 
+    gpuFrameTimeNew = false;
+
     auto result = swapchain->acquireNextImage(currentImageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
@@ -32,6 +98,9 @@ VkCommandBuffer vk::Renderer::beginFrame()
     frameInProgress = true;
     auto &command_buffer = getCurrentCommandBuffer();
 
+    frameStats = FrameStats{};
+    frameStats.frameNumber = frameNumber++;
+
     /* BEGIN COMMAND BUFFER --------------------------------------------------------------------------------- */
 
     VkCommandBufferBeginInfo begin = {};
@@ -40,21 +109,40 @@ VkCommandBuffer vk::Renderer::beginFrame()
     if (vkBeginCommandBuffer(command_buffer, &begin) != VK_SUCCESS)
         throw std::runtime_error("vk::Renderer::beginFrame: FAILED TO BEGIN RECORDING COMMAND BUFFER");
 
+    /* GPU FRAME TIME --------------------------------------------------------------------------------------- */
+
+    // Results arrive frames in flight late, the previous frame in this slot has finished
+    if (gpuProfiler.beginFrame(command_buffer, currentFrameIndex))
+    {
+        gpuFrameTime = gpuProfiler.getLastTime(FRAME_SCOPE);
+        gpuFrameTimeNew = true;
+
+        if (dynamicResolutionEnabled)
+            renderScale = dynamicResolution.update(gpuFrameTime);
+    }
+
+    gpuProfiler.beginScope(command_buffer, FRAME_SCOPE, false);
+
     return command_buffer;
 }
 
 void vk::Renderer::endFrame()
 {
+    SVKE_PROFILE_ZONE("vk::Renderer::endFrame");
+
     assert(frameInProgress && "CANNOT END FRAME WHEN NO FRAME IS IN PROGRESS");
 
     /* END COMMAND BUFFER ----------------------------------------------------------------------------------- */
 
     auto &command_buffer = getCurrentCommandBuffer();
 
+    gpuProfiler.endScope(command_buffer);
+
     if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
         throw std::runtime_error("vk::Renderer::endFrame: FAILED TO END COMMAND BUFFER");
 
     auto result = swapchain->submitCommandBuffers(command_buffer, currentImageIndex);
+    lastRenderedImage = static_cast<int>(currentImageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || window.wasResized())
     {
@@ -66,8 +154,17 @@ void vk::Renderer::endFrame()
         throw std::runtime_error("vk::Renderer::endFrame: FAILED TO PRESENT SWAPCHAIN IMAGE");
     }
 
+    /* FRAME STATS ------------------------------------------------------------------------------------------ */
+
+    if (frameStatsHistory.size() < FRAME_STATS_HISTORY)
+        frameStatsHistory.push_back(frameStats);
+    else
+        frameStatsHistory[nextFrameStats] = frameStats;
+
+    nextFrameStats = (nextFrameStats + 1) % FRAME_STATS_HISTORY;
+
     frameInProgress = false;
-    currentFrameIndex = (currentFrameIndex + 1) % Swapchain::MAX_FRAMES_IN_FLIGHT;
+    currentFrameIndex = (currentFrameIndex + 1) % static_cast<int>(framesInFlight);
 }
 
 void vk::Renderer::beginRenderPass(VkCommandBuffer &command_buffer)
@@ -76,53 +173,104 @@ void vk::Renderer::beginRenderPass(VkCommandBuffer &command_buffer)
     assert(command_buffer == getCurrentCommandBuffer() &&
            "CANNOT BEGIN RENDER PASS ON A COMMAND BUFFER FROM A DIFFERENT FRAME");
 
-    /* RENDER PASS BEGIN ------------------------------------------------------------------------------------ */
+    gpuProfiler.beginScope(command_buffer, RENDER_PASS_SCOPE, false);
 
-    VkRenderPassBeginInfo render_pass_begin = {};
-    render_pass_begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    render_pass_begin.renderPass = swapchain->getRenderPass();
-    render_pass_begin.framebuffer = swapchain->getFramebuffer(currentImageIndex);
-    render_pass_begin.renderArea.offset = {0, 0};
-    render_pass_begin.renderArea.extent = swapchain->getExtent();
+    if (renderingMode == Swapchain::RenderingMode::Dynamic)
+        beginDynamicRendering(command_buffer);
+    else
+        beginSwapchainRenderPass(command_buffer);
 
-    /* CLEAR COLOR AND DEPTH -------------------------------------------------------------------------------- */
+    setViewportAndScissor(command_buffer, getRenderExtent());
+}
 
-    std::array<VkClearValue, 2> clear_values;
-    clear_values[0].color = clearColor.toVkClearColorValue();
-    clear_values[1].depthStencil = {1.f, 0};
+void vk::Renderer::endRenderPass(VkCommandBuffer &command_buffer)
+{
+    assert(frameInProgress && "CANNOT END RENDER PASS WHEN NO FRAME IS IN PROGRESS");
+    assert(command_buffer == getCurrentCommandBuffer() &&
+           "CANNOT END RENDER PASS ON A COMMAND BUFFER FROM A DIFFERENT FRAME");
 
-    render_pass_begin.clearValueCount = static_cast<uint32_t>(clear_values.size());
-    render_pass_begin.pClearValues = clear_values.data();
+    /* END RENDER PASS -------------------------------------------------------------------------------------- */
 
-    vkCmdBeginRenderPass(command_buffer, &render_pass_begin, VK_SUBPASS_CONTENTS_INLINE);
+    if (renderingMode == Swapchain::RenderingMode::RenderPass)
+    {
+        vkCmdEndRenderPass(command_buffer);
+        gpuProfiler.endScope(command_buffer);
+        return;
+    }
 
-    /* VIEWPORT AND SCISSOR --------------------------------------------------------------------------------- */
+    vkCmdEndRendering(command_buffer);
+    gpuProfiler.endScope(command_buffer);
 
-    VkViewport viewport = {};
-    viewport.x = 0;
-    viewport.y = 0;
-    viewport.width = static_cast<float>(swapchain->getWidth());
-    viewport.height = static_cast<float>(swapchain->getHeight());
-    viewport.minDepth = 0.f;
-    viewport.maxDepth = 1.f;
+    // The upscale pass samples the internal target, the swapchain image is presented later
+    if (dynamicResolutionEnabled)
+    {
+        transitionImage(command_buffer, swapchain->getInternalImage(currentImageIndex), VK_IMAGE_ASPECT_COLOR_BIT,
+                        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        return;
+    }
 
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = swapchain->getExtent();
+    // What the render pass' final layout does otherwise
+    transitionImage(command_buffer, swapchain->getImage(currentImageIndex), VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, swapchain->getFinalLayout(),
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
 
-    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
-    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+void vk::Renderer::beginUpscalePass(VkCommandBuffer &command_buffer)
+{
+    assert(frameInProgress && "CANNOT BEGIN UPSCALE PASS WHEN NO FRAME IS IN PROGRESS");
+    assert(dynamicResolutionEnabled && "UPSCALE PASS REQUIRES DYNAMIC RESOLUTION");
+
+    gpuProfiler.beginScope(command_buffer, UPSCALE_PASS_SCOPE, false);
+
+    // Every pixel is overwritten, so previous contents are discarded
+    transitionImage(command_buffer, swapchain->getImage(currentImageIndex), VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    VkRenderingAttachmentInfo color_attachment = {};
+    color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    color_attachment.imageView = swapchain->getImageView(currentImageIndex);
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    VkRenderingInfo rendering_info = {};
+    rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    rendering_info.renderArea.offset = {0, 0};
+    rendering_info.renderArea.extent = swapchain->getExtent();
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments = &color_attachment;
+
+    vkCmdBeginRendering(command_buffer, &rendering_info);
+
+    setViewportAndScissor(command_buffer, swapchain->getExtent());
 }
 
-void vk::Renderer::endRenderPass(VkCommandBuffer &command_buffer)
+void vk::Renderer::endUpscalePass(VkCommandBuffer &command_buffer)
 {
-    assert(frameInProgress && "CANNOT END RENDER PASS WHEN NO FRAME IS IN PROGRESS");
-    assert(command_buffer == getCurrentCommandBuffer() &&
-           "CANNOT END RENDER PASS ON A COMMAND BUFFER FROM A DIFFERENT FRAME");
+    assert(frameInProgress && "CANNOT END UPSCALE PASS WHEN NO FRAME IS IN PROGRESS");
+    assert(dynamicResolutionEnabled && "UPSCALE PASS REQUIRES DYNAMIC RESOLUTION");
 
-    /* END RENDER PASS -------------------------------------------------------------------------------------- */
+    vkCmdEndRendering(command_buffer);
+    gpuProfiler.endScope(command_buffer);
 
-    vkCmdEndRenderPass(command_buffer);
+    transitionImage(command_buffer, swapchain->getImage(currentImageIndex), VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, swapchain->getFinalLayout(),
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
+
+void vk::Renderer::nextSubpass(VkCommandBuffer &command_buffer)
+{
+    assert(frameInProgress && "CANNOT ADVANCE SUBPASS WHEN NO FRAME IS IN PROGRESS");
+    assert(renderPath == Swapchain::RenderPath::Deferred && "ONLY THE DEFERRED RENDER PATH HAS MULTIPLE SUBPASSES");
+
+    vkCmdNextSubpass(command_buffer, VK_SUBPASS_CONTENTS_INLINE);
 }
 
 const bool vk::Renderer::isFrameInProgress() const
@@ -137,6 +285,128 @@ const int vk::Renderer::getCurrentFrameIndex() const
     return currentFrameIndex;
 }
 
+void vk::Renderer::setDynamicResolution(const bool enabled)
+{
+    assert(!frameInProgress && "CANNOT CHANGE DYNAMIC RESOLUTION WHILE A FRAME IS IN PROGRESS");
+
+    if (enabled == dynamicResolutionEnabled)
+        return;
+
+    if (enabled && renderingMode != Swapchain::RenderingMode::Dynamic)
+    {
+#ifndef NDEBUG
+        std::cout << "DYNAMIC RESOLUTION REQUIRES DYNAMIC RENDERING" << std::endl;
+#endif
+        return;
+    }
+
+#ifndef NDEBUG
+    if (enabled && !gpuProfiler.isSupported())
+        std::cout << "NO GPU TIMESTAMPS, DYNAMIC RESOLUTION STAYS AT ITS MAXIMUM SCALE" << std::endl;
+#endif
+
+    dynamicResolutionEnabled = enabled;
+    dynamicResolution.reset();
+    renderScale = enabled ? dynamicResolution.getScale() : 1.f;
+
+    // Adds or removes the internal target
+    recreateSwapchain();
+}
+
+const bool vk::Renderer::isDynamicResolutionEnabled() const
+{
+    return dynamicResolutionEnabled;
+}
+
+vk::DynamicResolution &vk::Renderer::getDynamicResolution()
+{
+    return dynamicResolution;
+}
+
+const float vk::Renderer::getRenderScale() const
+{
+    return renderScale;
+}
+
+const VkExtent2D vk::Renderer::getRenderExtent() const
+{
+    const VkExtent2D extent = swapchain->getExtent();
+
+    if (!dynamicResolutionEnabled)
+        return extent;
+
+    const auto scaled = [this](const uint32_t size) {
+        return std::max(1u, static_cast<uint32_t>(std::round(static_cast<float>(size) * renderScale)));
+    };
+
+    return {scaled(extent.width), scaled(extent.height)};
+}
+
+const float vk::Renderer::getGpuFrameTime() const
+{
+    return gpuFrameTime;
+}
+
+const bool vk::Renderer::isGpuFrameTimeNew() const
+{
+    return gpuFrameTimeNew;
+}
+
+vk::GpuProfiler &vk::Renderer::getGpuProfiler()
+{
+    return gpuProfiler;
+}
+
+vk::FrameStats &vk::Renderer::getFrameStats()
+{
+    return frameStats;
+}
+
+const vk::FrameStats vk::Renderer::getLastFrameStats() const
+{
+    if (frameStatsHistory.empty())
+        return FrameStats{};
+
+    return frameStatsHistory[(nextFrameStats + FRAME_STATS_HISTORY - 1) % FRAME_STATS_HISTORY];
+}
+
+const std::vector<vk::FrameStats> vk::Renderer::getFrameStatsHistory() const
+{
+    // Until the ring is full the oldest entry is the first one
+    if (frameStatsHistory.size() < FRAME_STATS_HISTORY)
+        return frameStatsHistory;
+
+    std::vector<FrameStats> history(frameStatsHistory.begin() + nextFrameStats, frameStatsHistory.end());
+    history.insert(history.end(), frameStatsHistory.begin(), frameStatsHistory.begin() + nextFrameStats);
+
+    return history;
+}
+
+const uint32_t vk::Renderer::getFramesInFlight() const
+{
+    return framesInFlight;
+}
+
+void vk::Renderer::setFrameRateLimit(const float frame_rate)
+{
+    frameLimiter.setTargetRate(frame_rate);
+}
+
+const float vk::Renderer::getFrameRateLimit() const
+{
+    return frameLimiter.getTargetRate();
+}
+
+void vk::Renderer::setLowLatencyMode(const bool enabled)
+{
+    lowLatencyMode = enabled;
+}
+
+const bool vk::Renderer::isLowLatencyMode() const
+{
+    return lowLatencyMode;
+}
+
 VkCommandBuffer &vk::Renderer::getCurrentCommandBuffer()
 {
     assert(frameInProgress && "CANNOT GET CURRENT BUFFER WHILE NO FRAME IS IN PROGRESS");
@@ -150,14 +420,118 @@ VkRenderPass vk::Renderer::getRenderPass()
     return swapchain->getRenderPass();
 }
 
+void vk::Renderer::setPipelineTarget(Pipeline::Config &config)
+{
+    if (renderingMode == Swapchain::RenderingMode::Dynamic)
+    {
+        config.renderPass = VK_NULL_HANDLE;
+        config.colorAttachmentFormats = {swapchain->getImageFormat()};
+        config.depthAttachmentFormat = swapchain->getDepthFormat();
+    }
+    else
+    {
+        config.renderPass = swapchain->getRenderPass();
+    }
+}
+
+void vk::Renderer::setPipelineManager(PipelineManager *pipeline_manager)
+{
+    pipelineManager = pipeline_manager;
+}
+
 const float vk::Renderer::getAspectRatio() const
 {
     return swapchain->getExtentAspectRatio();
 }
 
+const VkExtent2D vk::Renderer::getExtent() const
+{
+    return swapchain->getExtent();
+}
+
+const vk::Swapchain::RenderPath &vk::Renderer::getRenderPath() const
+{
+    return renderPath;
+}
+
+const vk::Swapchain::RenderingMode &vk::Renderer::getRenderingMode() const
+{
+    return renderingMode;
+}
+
+const VkSampleCountFlagBits vk::Renderer::getSampleCount() const
+{
+    return swapchain->getSampleCount();
+}
+
+const uint32_t vk::Renderer::getCurrentImageIndex() const
+{
+    assert(frameInProgress && "CANNOT GET CURRENT IMAGE INDEX WHILE NO FRAME IS IN PROGRESS");
+
+    return currentImageIndex;
+}
+
+const uint32_t vk::Renderer::getSwapchainGeneration() const
+{
+    return swapchainGeneration;
+}
+
+void vk::Renderer::readLastImage(std::vector<uint8_t> &pixels)
+{
+    assert(swapchain->isHeadless() && "ONLY HEADLESS IMAGES CAN BE READ BACK");
+    assert(!frameInProgress && "CANNOT READ BACK AN IMAGE WHILE A FRAME IS IN PROGRESS");
+
+    if (lastRenderedImage < 0)
+        throw std::runtime_error("vk::Renderer::readLastImage: NO FRAME WAS RENDERED YET");
+
+    const VkExtent2D extent = swapchain->getExtent();
+    const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+
+    Buffer staging_buffer(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_AUTO,
+                          VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+
+    swapchain->waitForLastSubmission();
+
+    VkCommandBuffer command_buffer = device.beginSingleTimeCommands();
+
+    // The image is already in its final layout, this only orders the copy after the frame's color writes
+    transitionImage(command_buffer, swapchain->getImage(lastRenderedImage), VK_IMAGE_ASPECT_COLOR_BIT,
+                    swapchain->getFinalLayout(), swapchain->getFinalLayout(),
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {extent.width, extent.height, 1};
+
+    vkCmdCopyImageToBuffer(command_buffer, swapchain->getImage(lastRenderedImage), swapchain->getFinalLayout(),
+                           staging_buffer.getBuffer(), 1, &region);
+
+    device.endSingleTimeCommands(command_buffer);
+
+    pixels.resize(size);
+
+    staging_buffer.map();
+    staging_buffer.invalidate();
+    staging_buffer.read(pixels.data(), size);
+    staging_buffer.unmap();
+}
+
+vk::Swapchain &vk::Renderer::getSwapchain()
+{
+    return *swapchain;
+}
+
 void vk::Renderer::createCommandBuffers()
 {
-    commandBuffers.resize(Swapchain::MAX_FRAMES_IN_FLIGHT);
+    commandBuffers.resize(framesInFlight);
 
     VkCommandBufferAllocateInfo alloc_info = {};
     alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -179,8 +553,14 @@ void vk::Renderer::freeCommandBuffers()
 
 void vk::Renderer::recreateSwapchain()
 {
+    SVKE_PROFILE_ZONE("vk::Renderer::recreateSwapchain");
+
     auto extent = window.getExtent();
 
+    // A headless window never changes size, waiting for events would block forever
+    if (window.isHeadless() && (extent.width == 0 || extent.height == 0))
+        throw std::runtime_error("vk::Renderer::recreateSwapchain: HEADLESS WINDOW HAS AN EMPTY EXTENT");
+
     while (extent.width == 0 || extent.height == 0)
     {
         extent = window.getExtent();
@@ -191,14 +571,151 @@ void vk::Renderer::recreateSwapchain()
 
     if (!swapchain)
     {
-        swapchain = std::make_unique<Swapchain>(device, window, preferredPresentMode);
+        swapchain = std::make_unique<Swapchain>(device, window, preferredPresentMode, renderPath, renderingMode,
+                                                framesInFlight, preferredImageCount, dynamicResolutionEnabled);
     }
     else
     {
         std::shared_ptr<Swapchain> old_swapchain = std::move(swapchain);
-        swapchain = std::make_unique<Swapchain>(device, window, old_swapchain, preferredPresentMode);
+        swapchain = std::make_unique<Swapchain>(device, window, old_swapchain, preferredPresentMode, renderPath,
+                                                renderingMode, framesInFlight, preferredImageCount,
+                                                dynamicResolutionEnabled);
 
         if (!old_swapchain->compatibleWith(*swapchain))
             throw std::runtime_error("vk::Renderer::recreateSwapchain: SWAPCHAIN IMAGE OR DEPTH FORMAT HAS CHANGED");
+
+        // The old render pass goes with the old swapchain, a later one may be created at the same handle value
+        if (pipelineManager != nullptr)
+            pipelineManager->releaseRenderPass(old_swapchain->getRenderPass());
+    }
+
+    lastRenderedImage = -1;
+    ++swapchainGeneration;
+}
+
+void vk::Renderer::beginSwapchainRenderPass(VkCommandBuffer &command_buffer)
+{
+    /* RENDER PASS BEGIN ------------------------------------------------------------------------------------ */
+
+    VkRenderPassBeginInfo render_pass_begin = {};
+    render_pass_begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_begin.renderPass = swapchain->getRenderPass();
+    render_pass_begin.framebuffer = swapchain->getFramebuffer(currentImageIndex);
+    render_pass_begin.renderArea.offset = {0, 0};
+    render_pass_begin.renderArea.extent = swapchain->getExtent();
+
+    /* CLEAR COLOR AND DEPTH -------------------------------------------------------------------------------- */
+
+    // Attachment 0 is always the final color target and 1 the depth buffer. Deferred adds the G-buffer
+    // (cleared to zero); forward's optional resolve attachment ignores its clear value.
+    std::array<VkClearValue, 4> clear_values = {};
+    clear_values[0].color = clearColor.toVkClearColorValue();
+    clear_values[1].depthStencil = {1.f, 0};
+
+    render_pass_begin.clearValueCount = swapchain->getAttachmentCount();
+    render_pass_begin.pClearValues = clear_values.data();
+
+    vkCmdBeginRenderPass(command_buffer, &render_pass_begin, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void vk::Renderer::beginDynamicRendering(VkCommandBuffer &command_buffer)
+{
+    const bool multisampled = swapchain->getSampleCount() != VK_SAMPLE_COUNT_1_BIT;
+    const VkFormat depth_format = swapchain->getDepthFormat();
+
+    // With dynamic resolution the scene goes to the internal target and reaches the swapchain image in the
+    // upscale pass
+    VkImage target_image = dynamicResolutionEnabled ? swapchain->getInternalImage(currentImageIndex)
+                                                    : swapchain->getImage(currentImageIndex);
+    VkImageView target_view = dynamicResolutionEnabled ? swapchain->getInternalImageView(currentImageIndex)
+                                                       : swapchain->getImageView(currentImageIndex);
+
+    // The internal target was last sampled by an upscale pass, which has to finish before it is overwritten
+    const VkPipelineStageFlags target_src_stage =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        (dynamicResolutionEnabled ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VkPipelineStageFlags{0});
+
+    /* LAYOUT TRANSITIONS ----------------------------------------------------------------------------------- */
+
+    // Every attachment is cleared, so previous contents are discarded by transitioning from UNDEFINED
+    transitionImage(command_buffer, target_image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, target_src_stage, 0,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    if (multisampled)
+        transitionImage(command_buffer, swapchain->getColorImage(), VK_IMAGE_ASPECT_COLOR_BIT,
+                        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    const VkImageAspectFlags depth_aspect =
+        VK_IMAGE_ASPECT_DEPTH_BIT | (hasStencilComponent(depth_format) ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+    const VkPipelineStageFlags depth_stages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+    transitionImage(command_buffer, swapchain->getDepthImage(currentImageIndex), depth_aspect,
+                    VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depth_stages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, depth_stages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+
+    /* ATTACHMENTS ------------------------------------------------------------------------------------------ */
+
+    VkRenderingAttachmentInfo color_attachment = {};
+    color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    color_attachment.imageView = target_view;
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.clearValue.color = clearColor.toVkClearColorValue();
+
+    // Multisampled: render to the transient target and resolve into the swapchain image or internal target
+    if (multisampled)
+    {
+        color_attachment.imageView = swapchain->getColorImageView();
+        color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        color_attachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        color_attachment.resolveImageView = target_view;
+        color_attachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     }
+
+    VkRenderingAttachmentInfo depth_attachment = {};
+    depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depth_attachment.imageView = swapchain->getDepthImageView(currentImageIndex);
+    depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.clearValue.depthStencil = {1.f, 0};
+
+    /* BEGIN RENDERING -------------------------------------------------------------------------------------- */
+
+    VkRenderingInfo rendering_info = {};
+    rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    rendering_info.renderArea.offset = {0, 0};
+    rendering_info.renderArea.extent = getRenderExtent();
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments = &color_attachment;
+    rendering_info.pDepthAttachment = &depth_attachment;
+
+    vkCmdBeginRendering(command_buffer, &rendering_info);
+}
+
+void vk::Renderer::setViewportAndScissor(VkCommandBuffer &command_buffer, const VkExtent2D &extent)
+{
+    /* VIEWPORT AND SCISSOR --------------------------------------------------------------------------------- */
+
+    VkViewport viewport = {};
+    viewport.x = 0;
+    viewport.y = 0;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.f;
+    viewport.maxDepth = 1.f;
+
+    VkRect2D scissor = {};
+    scissor.offset = {0, 0};
+    scissor.extent = extent;
+
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 }
@@ -1,51 +1,81 @@
 #include "SVKE/Rendering/Systems/TextureRenderSystem.hpp"
 
-vk::TextureRenderSystem::TextureRenderSystem(Device &device, Renderer &renderer,
+#include "SVKE/Core/Time/Profiler.hpp"
+
+vk::TextureRenderSystem::TextureRenderSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager,
                                              std::vector<VkDescriptorSetLayout> &set_layouts)
-    : device(device), pipelineLayout(VK_NULL_HANDLE)
+    : device(device), pipelineManager(pipeline_manager), pipelineLayout(VK_NULL_HANDLE)
 {
-    loadShaders();
+    loadShaders(renderer.getRenderPath());
     createPipelineLayout(set_layouts);
-    createPipeline(renderer.getRenderPass());
+    createPipeline(renderer, pipeline_manager);
 }
 
 vk::TextureRenderSystem::~TextureRenderSystem()
 {
+    // The layout must outlive a compilation that is still running
+    if (pipeline.isValid())
+        pipeline.wait();
+
+    pipelineManager.releasePipelineLayout(pipelineLayout);
     vkDestroyPipelineLayout(device.getLogicalDevice(), pipelineLayout, nullptr);
 }
 
 void vk::TextureRenderSystem::render(const FrameInfo &frame_info)
 {
-    pipeline->bind(frame_info.commandBuffer);
+    SVKE_PROFILE_ZONE("vk::TextureRenderSystem::render");
+
+    if (!pipeline.isReady())
+        return;
+
+    pipeline.get().bind(frame_info.commandBuffer);
 
     vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
                             &frame_info.globalDescriptorSet, 0, nullptr);
 
-    for (auto &[_, object] : frame_info.objects)
+    ++frame_info.stats.pipelineBinds;
+    ++frame_info.stats.descriptorSetBinds;
+
+    auto &textured_meshes = frame_info.scene.getTexturedMeshes();
+
+    for (size_t i = 0; i < textured_meshes.size(); ++i)
     {
-        if (!object.getTextureImage() || frame_info.objectDescriptorSets.size() == 0)
+        auto &textured_mesh = textured_meshes[i];
+
+        if (textured_mesh.descriptorSet == VK_NULL_HANDLE)
             continue;
 
+        const auto id = textured_meshes.getId(i);
+
         vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1,
-                                &frame_info.objectDescriptorSets[object.getId()], 0, nullptr);
+                                &textured_mesh.descriptorSet, 0, nullptr);
 
         PushConstantData push = {};
-        push.modelMatrix = object.transform();
-        push.normalMatrix = object.normalMatrix();
+        push.modelMatrix = frame_info.scene.getWorldMatrix(id);
+        push.normalMatrix = frame_info.scene.getNormalMatrix(id);
 
         vkCmdPushConstants(frame_info.commandBuffer, pipelineLayout,
                            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstantData),
                            &push);
 
-        object.bind(frame_info.commandBuffer);
-        object.draw(frame_info.commandBuffer);
+        textured_mesh.model->bind(frame_info.commandBuffer);
+        textured_mesh.model->draw(frame_info.commandBuffer);
+
+        ++frame_info.stats.descriptorSetBinds;
+        ++frame_info.stats.pushConstantUpdates;
+        frame_info.stats.addDraw(1, textured_mesh.model->getTriangleCount());
     }
 }
 
-void vk::TextureRenderSystem::loadShaders()
+void vk::TextureRenderSystem::loadShaders(const Swapchain::RenderPath &render_path)
 {
-    vertShader = std::make_unique<Shader>(device, "assets/shaders/texture_render_system.vert.spv");
-    fragShader = std::make_unique<Shader>(device, "assets/shaders/texture_render_system.frag.spv");
+    vertShader = std::make_shared<Shader>(device, "assets/shaders/mesh.vert.spv");
+
+    // The deferred path only writes the G-buffer here, shading happens in DeferredLightingSystem
+    if (render_path == Swapchain::RenderPath::Deferred)
+        fragShader = std::make_shared<Shader>(device, "assets/shaders/mesh_gbuffer_textured.frag.spv");
+    else
+        fragShader = std::make_shared<Shader>(device, "assets/shaders/mesh_textured.frag.spv");
 }
 
 void vk::TextureRenderSystem::createPipelineLayout(std::vector<VkDescriptorSetLayout> &set_layouts)
@@ -67,22 +97,33 @@ void vk::TextureRenderSystem::createPipelineLayout(std::vector<VkDescriptorSetLa
         throw std::runtime_error("vk::TextureRenderSystem::createPipelineLayout: FAILED TO CREATE PIPELINE LAYOUT");
 }
 
-void vk::TextureRenderSystem::createPipeline(VkRenderPass render_pass)
+void vk::TextureRenderSystem::createPipeline(Renderer &renderer, PipelineManager &pipeline_manager)
 {
     assert(pipelineLayout != VK_NULL_HANDLE && "CANNOT CREATE PIPELINE BEFORE PIPELINE LAYOUT");
 
-    Pipeline::Config pipeline_config = {};
-    Pipeline::defaultPipelineConfig(pipeline_config);
+    auto pipeline_config = std::make_unique<Pipeline::Config>();
+    Pipeline::defaultPipelineConfig(*pipeline_config);
 
-    pipeline_config.renderPass = render_pass;
-    pipeline_config.pipelineLayout = pipelineLayout;
-    pipeline_config.multisampleInfo.rasterizationSamples = device.getCurrentMsaaSamples();
-    pipeline_config.rasterizationInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-    pipeline_config.rasterizationInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    renderer.setPipelineTarget(*pipeline_config);
+    pipeline_config->pipelineLayout = pipelineLayout;
+    pipeline_config->multisampleInfo.rasterizationSamples = renderer.getSampleCount();
+    pipeline_config->rasterizationInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+    pipeline_config->rasterizationInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
     // Optional: Shader antialiasing, smooths inner parts of shapes. Might cost some performance
-    pipeline_config.multisampleInfo.sampleShadingEnable = VK_TRUE;
-    pipeline_config.multisampleInfo.minSampleShading = .2f;
+    pipeline_config->multisampleInfo.sampleShadingEnable = VK_TRUE;
+    pipeline_config->multisampleInfo.minSampleShading = .2f;
+
+    if (renderer.getRenderPath() == Swapchain::RenderPath::Deferred)
+    {
+        // Albedo and normal targets
+        pipeline_config->subpass = Swapchain::GEOMETRY_SUBPASS;
+        Pipeline::setColorAttachmentCount(*pipeline_config, 2);
+    }
+
+    MeshShaderVariant variant = {};
+    variant.apply(pipeline_config->fragSpecialization);
 
-    pipeline = std::make_unique<Pipeline>(device, *vertShader, *fragShader, pipeline_config);
+    // Compiled on a worker thread, render() skips drawing until it is ready
+    pipeline = pipeline_manager.request(vertShader, fragShader, std::move(pipeline_config));
 }
@@ -0,0 +1,175 @@
+#include "SVKE/Rendering/Systems/UpscaleSystem.hpp"
+
+#include "SVKE/Core/Time/Profiler.hpp"
+
+#include <algorithm>
+
+vk::UpscaleSystem::UpscaleSystem(Device &device, Renderer &renderer, PipelineManager &pipeline_manager)
+    : device(device), pipelineManager(pipeline_manager), renderer(renderer), pipelineLayout(VK_NULL_HANDLE),
+      sourceSetsGeneration(0), sharpness(0.f)
+{
+    assert(renderer.isDynamicResolutionEnabled() && "RENDERER DOES NOT USE DYNAMIC RESOLUTION");
+
+    loadShaders();
+    createSampler();
+    createSourceDescriptors();
+    writeSourceDescriptorSets();
+    createPipelineLayout();
+    createPipeline(pipeline_manager);
+}
+
+vk::UpscaleSystem::~UpscaleSystem()
+{
+    // The layout must outlive a compilation that is still running
+    if (pipeline.isValid())
+        pipeline.wait();
+
+    pipelineManager.releasePipelineLayout(pipelineLayout);
+    vkDestroyPipelineLayout(device.getLogicalDevice(), pipelineLayout, nullptr);
+}
+
+void vk::UpscaleSystem::render(const FrameInfo &frame_info)
+{
+    SVKE_PROFILE_ZONE("vk::UpscaleSystem::render");
+
+    if (!pipeline.isReady())
+        return;
+
+    // The swapchain was recreated since the sets were written, the device is idle at this point
+    if (sourceSetsGeneration != renderer.getSwapchainGeneration())
+        writeSourceDescriptorSets();
+
+    pipeline.get().bind(frame_info.commandBuffer);
+
+    vkCmdBindDescriptorSets(frame_info.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                            &sourceSets[renderer.getCurrentImageIndex()], 0, nullptr);
+
+    // The internal target has the swapchain's extent, the scene only covers its top left render extent
+    const VkExtent2D extent = renderer.getExtent();
+    const VkExtent2D render_extent = renderer.getRenderExtent();
+
+    PushConstantData push = {};
+    push.uvScale = {static_cast<float>(render_extent.width) / static_cast<float>(extent.width),
+                    static_cast<float>(render_extent.height) / static_cast<float>(extent.height)};
+    push.texelSize = {1.f / static_cast<float>(extent.width), 1.f / static_cast<float>(extent.height)};
+    push.sharpness = sharpness;
+
+    vkCmdPushConstants(frame_info.commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                       sizeof(PushConstantData), &push);
+
+    vkCmdDraw(frame_info.commandBuffer, 3, 1, 0, 0);
+
+    ++frame_info.stats.pipelineBinds;
+    ++frame_info.stats.descriptorSetBinds;
+    ++frame_info.stats.pushConstantUpdates;
+    frame_info.stats.addDraw(1, 1);
+}
+
+void vk::UpscaleSystem::setSharpness(const float sharpness)
+{
+    this->sharpness = std::max(sharpness, 0.f);
+}
+
+const float vk::UpscaleSystem::getSharpness() const
+{
+    return sharpness;
+}
+
+void vk::UpscaleSystem::loadShaders()
+{
+    vertShader = std::make_shared<Shader>(device, "assets/shaders/fullscreen.vert.spv");
+    fragShader = std::make_shared<Shader>(device, "assets/shaders/upscale.frag.spv");
+}
+
+void vk::UpscaleSystem::createSampler()
+{
+    TextureSampler::Config sampler_config{};
+    TextureSampler::defaultTextureSamplerConfig(sampler_config);
+
+    // Keeps the filter from wrapping around to the opposite edge
+    sampler_config.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_config.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_config.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    sampler = std::make_unique<TextureSampler>(device, sampler_config);
+}
+
+void vk::UpscaleSystem::createSourceDescriptors()
+{
+    sourceSetLayout = DescriptorSetLayout::Builder(device)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                          .build();
+
+    sourcePool = DescriptorPool::Builder(device)
+                     .setMaxSets(MAX_SWAPCHAIN_IMAGES)
+                     .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_SWAPCHAIN_IMAGES)
+                     .build();
+}
+
+void vk::UpscaleSystem::writeSourceDescriptorSets()
+{
+    Swapchain &swapchain = renderer.getSwapchain();
+    const size_t image_count = swapchain.getImageCount();
+
+    assert(image_count <= MAX_SWAPCHAIN_IMAGES && "TOO MANY SWAPCHAIN IMAGES FOR THE SAMPLER POOL");
+
+    sourcePool->resetPool();
+    sourceSets.assign(image_count, VK_NULL_HANDLE);
+
+    for (size_t i = 0; i < image_count; ++i)
+    {
+        VkDescriptorImageInfo source_info = {};
+        source_info.sampler = sampler->getSampler();
+        source_info.imageView = swapchain.getInternalImageView(static_cast<int>(i));
+        source_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        if (!DescriptorWriter(*sourceSetLayout, *sourcePool).writeImage(0, source_info).build(sourceSets[i]))
+            throw std::runtime_error(
+                "vk::UpscaleSystem::writeSourceDescriptorSets: FAILED TO ALLOCATE INTERNAL TARGET SET");
+    }
+
+    sourceSetsGeneration = renderer.getSwapchainGeneration();
+}
+
+void vk::UpscaleSystem::createPipelineLayout()
+{
+    VkDescriptorSetLayout set_layout = sourceSetLayout->getDescriptorSetLayout();
+
+    VkPushConstantRange push_constant_range = {};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = sizeof(PushConstantData);
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info = {};
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount = 1;
+    pipeline_layout_info.pSetLayouts = &set_layout;
+    pipeline_layout_info.pushConstantRangeCount = 1;
+    pipeline_layout_info.pPushConstantRanges = &push_constant_range;
+
+    if (vkCreatePipelineLayout(device.getLogicalDevice(), &pipeline_layout_info, nullptr, &pipelineLayout) !=
+        VK_SUCCESS)
+        throw std::runtime_error("vk::UpscaleSystem::createPipelineLayout: FAILED TO CREATE PIPELINE LAYOUT");
+}
+
+void vk::UpscaleSystem::createPipeline(PipelineManager &pipeline_manager)
+{
+    assert(pipelineLayout != VK_NULL_HANDLE && "CANNOT CREATE PIPELINE BEFORE PIPELINE LAYOUT");
+
+    auto pipeline_config = std::make_unique<Pipeline::Config>();
+    Pipeline::defaultPipelineConfig(*pipeline_config);
+
+    pipeline_config->attributeDescriptions.clear();
+    pipeline_config->bindingDescriptions.clear();
+    renderer.setPipelineTarget(*pipeline_config);
+    pipeline_config->pipelineLayout = pipelineLayout;
+
+    // The upscale pass renders to the swapchain image alone: one sample, no depth attachment
+    pipeline_config->depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    pipeline_config->multisampleInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    pipeline_config->depthStencilInfo.depthTestEnable = VK_FALSE;
+    pipeline_config->depthStencilInfo.depthWriteEnable = VK_FALSE;
+
+    // Compiled on a worker thread, render() skips drawing until it is ready
+    pipeline = pipeline_manager.request(vertShader, fragShader, std::move(pipeline_config));
+}